@@ -7,12 +7,23 @@ const char* HELP_TEXT =
 "ccsponge pname ... "
 "[-nomain] "
 "[-nomerge] "
+"[-lshistory] "
+"[-localdiff] "
+"[-headersonly] "
+"[-resume] "
 "[-after DATE] "
 "[-before DATE] "
 "[-period PERIOD] "
+"[-batch SIZE] "
+"[-cachemb SIZE] "
+"[-cache FILE] "
+"[-incremental FILE] "
 "[-users USER-LIST] "
 "[-brtypes BRTYPE-LIST] "
-"[-exts EXTENSION-LIST]"
+"[-exts EXTENSION-LIST] "
+"[-include PATTERN-LIST] "
+"[-exclude PATTERN-LIST] "
+"[-groupby DIMENSION-LIST]"
 "\n\nEnter -help [OPTION] for help on a specific option\n";
 
 const char* EXTRA_PARAM_TEXT =
@@ -38,6 +49,37 @@ const char* NOMERGE_HELP_TEXT =
 "ignoring rebase versions. Be cautious with this option as it may "
 "ignore legitamate changes.";
 
+const char* LSHISTORY_HELP_TEXT =
+"-lshistory\nFinds versions with \"cleartool lshistory -recurse\" instead "
+"of \"cleartool find\". The history lists every version already described, "
+"and is usually cheaper for the VOB server. The -before DATE must then be "
+"in the form 2006-09-08 or 08-Sep-2006, optionally followed by a time.";
+
+const char* LOCALDIFF_HELP_TEXT =
+"-localdiff\nCompares each version with its predecessor inside ccsponge, "
+"reading both through their version extended path names, instead of "
+"running \"cleartool diff\". Needs a view the versions can be read in, "
+"such as a dynamic view. Versions containing binary data are skipped. "
+"Versions whose predecessor can't be worked out from their description or "
+"name are still diffed by cleartool.\n\nThe counts are approximate. The "
+"comparison follows GNU diff, which can pair up lines differently from "
+"\"cleartool diff\" where a change can be described several equally short "
+"ways, so a few lines may move between added, changed and removed.";
+
+const char* HEADERSONLY_HELP_TEXT =
+"-headersonly\nAsks \"cleartool diff\" for only the line range of each "
+"difference instead of every changed line, which is all ccsponge counts. "
+"Cuts the diff output to a line per change however large the change is. "
+"Ignored if -localdiff is passed.";
+
+const char* RESUME_HELP_TEXT =
+"-resume\nPicks up a run that died before writing its output. While "
+"running, ccsponge records each version it finishes in a journal next to "
+"the output file, named like \"sponge.out.journal\". With -resume the "
+"counts in the journal are kept and those versions, including ones without "
+"changes or that were skipped, are not analyzed again. Pass "
+"the same options as the run being resumed.";
+
 const char* AFTER_HELP_TEXT =
 "-after DATE\nIgnores versions before the specified DATE. The passed "
 "date must be a date in a format clearcase recognizes. If -after is not "
@@ -53,6 +95,32 @@ const char* PERIOD_HELP_TEXT =
 "Supported PERIOD values are: \"daily\", \"weekly\", \"monthly\". If "
 "-period is not passed, defaults to \"weekly\"";
 
+const char* BATCH_HELP_TEXT =
+"-batch SIZE\nSpecifies how many versions to describe with each "
+"\"cleartool describe\" command. Larger batches spread the cost of each "
+"command over more versions. If -batch is "
+"not passed, defaults to 64.";
+
+const char* CACHEMB_HELP_TEXT =
+"-cachemb SIZE\nSpecifies how many megabytes of version text -localdiff "
+"keeps in memory. Versions of the same element are compared in order, so "
+"each version read is reused as the predecessor of the next one. Passing "
+"0 turns the cache off. If -cachemb is not passed, defaults to 64.";
+
+const char* CACHE_HELP_TEXT =
+"-cache FILE\nKeeps the result of analyzing each version in FILE, which is "
+"created if it doesn't exist. Versions already in the file are not "
+"described or diffed again, so repeated runs over the same history only "
+"ask cleartool about new versions. Versions that fail to analyze are not "
+"kept and are tried again the next time. Results found with -localdiff or "
+"-headersonly are only used by later runs passing the same option.";
+
+const char* INCREMENTAL_HELP_TEXT =
+"-incremental FILE\nKeeps the totals written to the output in FILE, along "
+"with the creation time of the newest version counted. The next run with "
+"the same FILE only looks at versions created after that time and adds "
+"them to the saved totals. The -period must stay the same between runs.";
+
 const char* USERS_HELP_TEXT =
 "-users USER-LIST\nSpecifies a list of users to look for when examining "
 "versions. Versions created by users that are not in the passed list will "
@@ -72,6 +140,30 @@ const char* EXTS_HELP_TEXT =
 "ignored. The EXTENSION-LIST should be comma delimited: \".h, .cpp,.hpp\". "
 "If -exts is not passed, all extensions are allowed.";
 
+const char* INCLUDE_HELP_TEXT =
+"-include PATTERN-LIST\nSpecifies a list of patterns for the elements to "
+"examine. Versions of elements that match none of the patterns will be "
+"ignored. In a pattern * matches any characters and ? matches any single "
+"character. A pattern containing a / or \\ is matched against the whole "
+"element path, otherwise just the file name: \"*.c, */test/*\". If "
+"-include is not passed, all elements are examined.";
+
+const char* EXCLUDE_HELP_TEXT =
+"-exclude PATTERN-LIST\nSpecifies a list of patterns for elements to "
+"ignore, in the same form as for -include. Versions of elements that match "
+"any of the patterns will be ignored, even if they match -include or "
+"-exts.";
+
+const char* GROUPBY_HELP_TEXT =
+"-groupby DIMENSION-LIST\nAlso writes the counts of each period broken "
+"down by the passed dimensions, one report per dimension, from the same "
+"run. Supported dimensions are: \"user\" for the creator of the version, "
+"\"brtype\" for the branch it is on, \"ext\" for the file extension and "
+"\"dir\" for the first directory below the pname it was found under. The "
+"report for each is written next to the output file, named like "
+"\"sponge.out.user.csv\". Totals restored by -incremental are not broken "
+"down, only the versions counted by the run.";
+
 bool Help::isHelpParam(String param)
 {
 	return (param.equalsIgnoringCase("h") ||
@@ -140,6 +232,22 @@ const char* Help::getHelpMessage(Array<String>& parameters)
 	{
 		return NOMERGE_HELP_TEXT;
 	}
+	else if (param.equals("lshistory"))
+	{
+		return LSHISTORY_HELP_TEXT;
+	}
+	else if (param.equals("localdiff"))
+	{
+		return LOCALDIFF_HELP_TEXT;
+	}
+	else if (param.equals("headersonly"))
+	{
+		return HEADERSONLY_HELP_TEXT;
+	}
+	else if (param.equals("resume"))
+	{
+		return RESUME_HELP_TEXT;
+	}
 	else if (param.equals("after"))
 	{
 		return AFTER_HELP_TEXT;
@@ -152,6 +260,22 @@ const char* Help::getHelpMessage(Array<String>& parameters)
 	{
 		return PERIOD_HELP_TEXT;
 	}
+	else if (param.equals("batch"))
+	{
+		return BATCH_HELP_TEXT;
+	}
+	else if (param.equals("cachemb"))
+	{
+		return CACHEMB_HELP_TEXT;
+	}
+	else if (param.equals("cache"))
+	{
+		return CACHE_HELP_TEXT;
+	}
+	else if (param.equals("incremental"))
+	{
+		return INCREMENTAL_HELP_TEXT;
+	}
 	else if (param.equals("users"))
 	{
 		return USERS_HELP_TEXT;
@@ -164,6 +288,18 @@ const char* Help::getHelpMessage(Array<String>& parameters)
 	{
 		return EXTS_HELP_TEXT;
 	}
+	else if (param.equals("include"))
+	{
+		return INCLUDE_HELP_TEXT;
+	}
+	else if (param.equals("exclude"))
+	{
+		return EXCLUDE_HELP_TEXT;
+	}
+	else if (param.equals("groupby"))
+	{
+		return GROUPBY_HELP_TEXT;
+	}
 	else
 	{
 		return BAD_HELP_TEXT;
@@ -7,7 +7,13 @@ Settings::Settings()
 	// Defaults
 	m_excludeMerges = false;
 	m_excludeMain = false;
+	m_useHistory = false;
+	m_localDiff = false;
+	m_resume = false;
+	m_headersOnly = false;
 	m_period = WEEKLY;
+	m_batchSize = 64;
+	m_cacheSize = 64;
 	m_outputFile = String("sponge.out");
 }
 
@@ -15,14 +21,26 @@ Settings::Settings(const Settings& other)
 {
 	m_excludeMerges = other.m_excludeMerges;
 	m_excludeMain = other.m_excludeMain;
+	m_useHistory = other.m_useHistory;
+	m_localDiff = other.m_localDiff;
+	m_resume = other.m_resume;
+	m_headersOnly = other.m_headersOnly;
 	m_period = other.m_period;
+	m_batchSize = other.m_batchSize;
+	m_cacheSize = other.m_cacheSize;
 	m_outputFile = other.m_outputFile;
+	m_cacheFile = other.m_cacheFile;
+	m_stateFile = other.m_stateFile;
 	m_afterDate = other.m_afterDate;
 	m_beforeDate = other.m_beforeDate;
 	m_users = other.m_users;
 	m_brtypes = other.m_brtypes;
 	m_extensions = other.m_extensions;
+	m_includes = other.m_includes;
+	m_excludes = other.m_excludes;
 	m_paths = other.m_paths;
+	m_groupBy = other.m_groupBy;
+	m_filter = other.m_filter;
 }
 
 Settings::~Settings()
@@ -67,6 +85,22 @@ bool Settings::populate(Array<String>& parameters, String& error)
 		{
 			m_excludeMerges = true;
 		}
+		else if (param.equals("-lshistory"))
+		{
+			m_useHistory = true;
+		}
+		else if (param.equals("-localdiff"))
+		{
+			m_localDiff = true;
+		}
+		else if (param.equals("-headersonly"))
+		{
+			m_headersOnly = true;
+		}
+		else if (param.equals("-resume"))
+		{
+			m_resume = true;
+		}
 		else if (param.equals("-o"))
 		{
 			if (index == parameters.size() - 1)
@@ -78,6 +112,28 @@ bool Settings::populate(Array<String>& parameters, String& error)
 			index++;
 			m_outputFile = parameters.get(index);
 		}
+		else if (param.equals("-cache"))
+		{
+			if (index == parameters.size() - 1)
+			{
+				error = "Missing cache filename after -cache";
+				return false;
+			}
+
+			index++;
+			m_cacheFile = parameters.get(index);
+		}
+		else if (param.equals("-incremental"))
+		{
+			if (index == parameters.size() - 1)
+			{
+				error = "Missing state filename after -incremental";
+				return false;
+			}
+
+			index++;
+			m_stateFile = parameters.get(index);
+		}
 		else if (param.equals("-after"))
 		{
 			if (index == parameters.size() - 1)
@@ -116,6 +172,43 @@ bool Settings::populate(Array<String>& parameters, String& error)
 				return false;
 			}
 		}
+		else if (param.equals("-batch"))
+		{
+			if (index == parameters.size() - 1)
+			{
+				error = "Missing number after option -batch";
+				return false;
+			}
+
+			index++;
+			bool isInt = true;
+			m_batchSize = parameters.get(index).toUInt32(isInt);
+
+			if (!isInt || m_batchSize == 0)
+			{
+				error = String("Invalid batch size: ") + parameters.get(index);
+				return false;
+			}
+		}
+		else if (param.equals("-cachemb"))
+		{
+			if (index == parameters.size() - 1)
+			{
+				error = "Missing number after option -cachemb";
+				return false;
+			}
+
+			index++;
+			bool isInt = true;
+			m_cacheSize = parameters.get(index).toUInt32(isInt);
+
+			// The cache counts bytes in 32 bits
+			if (!isInt || m_cacheSize > 4095)
+			{
+				error = String("Invalid cache size: ") + parameters.get(index);
+				return false;
+			}
+		}
 		else if (param.equals("-users"))
 		{
 			if (index == parameters.size() - 1)
@@ -154,6 +247,44 @@ bool Settings::populate(Array<String>& parameters, String& error)
 				return false;
 			}
 		}
+		else if (param.equals("-include"))
+		{
+			if (index == parameters.size() - 1)
+			{
+				error = "Missing pattern list after option -include";
+				return false;
+			}
+
+			index++;
+			parseList(parameters.get(index), m_includes);
+		}
+		else if (param.equals("-exclude"))
+		{
+			if (index == parameters.size() - 1)
+			{
+				error = "Missing pattern list after option -exclude";
+				return false;
+			}
+
+			index++;
+			parseList(parameters.get(index), m_excludes);
+		}
+		else if (param.equals("-groupby"))
+		{
+			if (index == parameters.size() - 1)
+			{
+				error = "Missing dimension list after option -groupby";
+				return false;
+			}
+
+			index++;
+			parseDimensionList(parameters.get(index), m_groupBy, error);
+
+			if (error.length() > 0)
+			{
+				return false;
+			}
+		}
 		else
 		{
 			error = String("Unknown parameter: ") + param + "\nUse -help for help";
@@ -163,6 +294,7 @@ bool Settings::populate(Array<String>& parameters, String& error)
 		index++;
 	}
 
+	m_filter.compile(m_extensions, m_includes, m_excludes);
 	return true;
 }
 
@@ -176,16 +308,56 @@ bool Settings::getMainExcluded()
 	return m_excludeMain;
 }
 
+bool Settings::getUseHistory()
+{
+	return m_useHistory;
+}
+
+bool Settings::getLocalDiff()
+{
+	return m_localDiff;
+}
+
+bool Settings::getHeadersOnly()
+{
+	return m_headersOnly;
+}
+
+bool Settings::getResume()
+{
+	return m_resume;
+}
+
 Settings::timePeriod Settings::getPeriod()
 {
 	return m_period;
 }
 
+uint32 Settings::getBatchSize()
+{
+	return m_batchSize;
+}
+
+uint32 Settings::getCacheSize()
+{
+	return m_cacheSize;
+}
+
 String Settings::getOutputFile()
 {
 	return m_outputFile;
 }
 
+String Settings::getCacheFile()
+{
+	return m_cacheFile;
+}
+
+String Settings::getStateFile()
+{
+	return m_stateFile;
+}
+
 String Settings::getAfterDate()
 {
 	return m_afterDate;
@@ -196,26 +368,46 @@ String Settings::getBeforeDate()
 	return m_beforeDate;
 }
 
-vector<String> Settings::getUsers()
+const vector<String>& Settings::getUsers()
 {
 	return m_users;
 }
 
-vector<String> Settings::getBrtypes()
+const vector<String>& Settings::getBrtypes()
 {
 	return m_brtypes;
 }
 
-vector<String> Settings::getExtensions()
+const vector<String>& Settings::getExtensions()
 {
 	return m_extensions;
 }
 
-vector<String> Settings::getPaths()
+const vector<String>& Settings::getIncludes()
+{
+	return m_includes;
+}
+
+const vector<String>& Settings::getExcludes()
+{
+	return m_excludes;
+}
+
+const VersionFilter& Settings::getFilter()
+{
+	return m_filter;
+}
+
+const vector<String>& Settings::getPaths()
 {
 	return m_paths;
 }
 
+const vector<Settings::dimension>& Settings::getGroupBy()
+{
+	return m_groupBy;
+}
+
 Settings& Settings::operator=(const Settings& other)
 {
 	if (this == &other)
@@ -223,16 +415,45 @@ Settings& Settings::operator=(const Settings& other)
 
 	m_excludeMerges = other.m_excludeMerges;
 	m_excludeMain = other.m_excludeMain;
+	m_useHistory = other.m_useHistory;
+	m_localDiff = other.m_localDiff;
+	m_resume = other.m_resume;
+	m_headersOnly = other.m_headersOnly;
 	m_period = other.m_period;
+	m_batchSize = other.m_batchSize;
+	m_cacheSize = other.m_cacheSize;
+	m_cacheFile = other.m_cacheFile;
+	m_stateFile = other.m_stateFile;
 	m_afterDate = other.m_afterDate;
 	m_beforeDate = other.m_beforeDate;
 	m_users = other.m_users;
 	m_brtypes = other.m_brtypes;
 	m_extensions = other.m_extensions;
+	m_includes = other.m_includes;
+	m_excludes = other.m_excludes;
 	m_paths = other.m_paths;
+	m_groupBy = other.m_groupBy;
+	m_filter = other.m_filter;
 	return *this;
 }
 
+String Settings::getDimensionName(dimension value)
+{
+	switch (value)
+	{
+		case USER:
+			return String("user");
+		case BRTYPE:
+			return String("brtype");
+		case EXTENSION:
+			return String("ext");
+		case DIRECTORY:
+			return String("dir");
+		default:
+			return String();
+	}
+}
+
 Settings::timePeriod Settings::parsePeriod(String value, String& error)
 {
 	if (value.equalsIgnoringCase("day") ||
@@ -322,3 +543,42 @@ void Settings::parseExtensionList(String list, vector<String>& toPopulate, Strin
 		}
 	}
 }
+
+void Settings::parseDimensionList(String list, vector<dimension>& toPopulate, String& error)
+{
+	vector<String> names;
+	parseList(list, names);
+	toPopulate.clear();
+
+	for (uint32 i = 0; i < names.size(); i++)
+	{
+		uint32 value = 0;
+
+		while (value < DIMENSION_COUNT &&
+			   !names[i].equalsIgnoringCase(getDimensionName((dimension)value)))
+		{
+			value++;
+		}
+
+		if (value == DIMENSION_COUNT)
+		{
+			toPopulate.clear();
+			error = String("Unknown -groupby dimension: ") + names[i] +
+				"\nSupported dimensions are: user, brtype, ext, dir";
+			return;
+		}
+
+		// Each dimension gets one report however often it's named
+		bool isDuplicate = false;
+
+		for (uint32 j = 0; j < toPopulate.size(); j++)
+		{
+			isDuplicate = isDuplicate || (toPopulate[j] == value);
+		}
+
+		if (!isDuplicate)
+		{
+			toPopulate.push_back((dimension)value);
+		}
+	}
+}
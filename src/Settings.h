@@ -3,6 +3,7 @@
 #ifndef SETTINGS_H
 #define SETTINGS_H
 
+#include <clearcase/VersionFilter.h>
 #include <text/String.h>
 #include <util/Array.h>
 
@@ -22,6 +23,18 @@ public:
 		MONTHLY,
 	};
 
+	/*
+	 * What the -groupby reports can break the counts down by
+	 */
+	enum dimension
+	{
+		USER,
+		BRTYPE,
+		EXTENSION,
+		DIRECTORY,
+		DIMENSION_COUNT,
+	};
+
 	Settings();
 	Settings(const Settings& other);
 	~Settings();
@@ -30,36 +43,71 @@ public:
 
 	bool getMergesExcluded();
 	bool getMainExcluded();
+	bool getUseHistory();
+	bool getLocalDiff();
+	bool getHeadersOnly();
+	bool getResume();
 
 	timePeriod getPeriod();
+	uint32 getBatchSize();
+	uint32 getCacheSize();
 
 	String getOutputFile();
+	String getCacheFile();
+	String getStateFile();
 	String getAfterDate();
 	String getBeforeDate();
 
-	vector<String> getUsers();
-	vector<String> getBrtypes();
-	vector<String> getExtensions();
-	vector<String> getPaths();
+	const vector<String>& getUsers();
+	const vector<String>& getBrtypes();
+	const vector<String>& getExtensions();
+	const vector<String>& getIncludes();
+	const vector<String>& getExcludes();
+	const vector<String>& getPaths();
+	const vector<dimension>& getGroupBy();
+
+	/*
+	 * Returns the -exts, -include and -exclude filters, compiled by
+	 * populate().
+	 */
+	const VersionFilter& getFilter();
 
 	Settings& operator=(const Settings& other);
 
+	/*
+	 * Returns the name of a dimension as given to -groupby
+	 */
+	static String getDimensionName(dimension value);
+
 private:
 	timePeriod parsePeriod(String value, String& error);
 	void parseList(String list, vector<String>& toPopulate);
 	void parseExtensionList(String list, vector<String>& toPopulate, String& error);
+	void parseDimensionList(String list, vector<dimension>& toPopulate, String& error);
 
 private:
 	bool m_excludeMerges;
 	bool m_excludeMain;
+	bool m_useHistory;
+	bool m_localDiff;
+	bool m_headersOnly;
+	bool m_resume;
 	timePeriod m_period;
+	uint32 m_batchSize;
+	uint32 m_cacheSize; // In megabytes
 	String m_outputFile;
+	String m_cacheFile;
+	String m_stateFile;
 	String m_afterDate;
 	String m_beforeDate;
 	vector<String> m_users;
 	vector<String> m_brtypes;
 	vector<String> m_extensions;
+	vector<String> m_includes;
+	vector<String> m_excludes;
 	vector<String> m_paths;
+	vector<dimension> m_groupBy;
+	VersionFilter m_filter;
 };
 
 #endif // SETTINGS_H
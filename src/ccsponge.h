@@ -21,6 +21,23 @@
 #	define UNIX
 #endif
 
+// SSE2 is always there on x86-64, and on 32 bit x86 if the compiler was
+// told to use it
+#if !defined(HAS_SSE2)
+#	if defined(__SSE2__) || defined(_M_X64) || \
+	   (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#		define HAS_SSE2
+#	endif
+#endif
+
+// Rvalue references and move constructors came with C++11, and with
+// Visual Studio 2010 before that
+#if !defined(HAS_RVALUE_REFS)
+#	if __cplusplus >= 201103L || (defined(_MSC_VER) && _MSC_VER >= 1600)
+#		define HAS_RVALUE_REFS
+#	endif
+#endif
+
 // Standard Windows imports and defines
 // Note that we do not want to import windows.h more than once
 #if defined(WINDOWS)
@@ -1,24 +1,65 @@
 // AnalyzeTask.cpp
 
 #include "AnalyzeTask.h"
+#include <clearcase/DiffCounter.h>
+#include <clearcase/VersionName.h>
+#include <exception/IOException.h>
 #include <exception/ParsingException.h>
-#include <io/InputStream.h>
-#include <io/TextReader.h>
-#include <thread/Process.h>
+#include <exception/SystemException.h>
+#include <io/FileInputStream.h>
+#include <text/StringView.h>
 
+#include <ctype.h> // For isdigit()
 #include <iostream>
-#include <vector>
+#include <string.h> // For memchr()
 using namespace std;
 
+// How much of a version file to read at a time for -localdiff
+#define READ_BUFFER_SIZE 65536
+
 AnalyzeTask::AnalyzeTask(ThreadPool* threadPool,
 						 DataStore* dataStore,
 						 Settings* settings,
+						 CleartoolSessionPool* sessionPool,
+						 ContentCache* contentCache,
+						 ResultCache* resultCache,
+						 ProgressJournal* journal,
 						 String& versionName)
+{
+	init(threadPool, dataStore, settings, sessionPool, contentCache, resultCache, journal, versionName);
+}
+
+AnalyzeTask::AnalyzeTask(ThreadPool* threadPool,
+						 DataStore* dataStore,
+						 Settings* settings,
+						 CleartoolSessionPool* sessionPool,
+						 ContentCache* contentCache,
+						 ResultCache* resultCache,
+						 ProgressJournal* journal,
+						 String& versionName,
+						 String& descriptionRecord)
+{
+	init(threadPool, dataStore, settings, sessionPool, contentCache, resultCache, journal, versionName);
+	m_descriptionRecord.swap(descriptionRecord);
+}
+
+void AnalyzeTask::init(ThreadPool* threadPool,
+					   DataStore* dataStore,
+					   Settings* settings,
+					   CleartoolSessionPool* sessionPool,
+					   ContentCache* contentCache,
+					   ResultCache* resultCache,
+					   ProgressJournal* journal,
+					   String& versionName)
 {
 	m_threadPool = threadPool;
 	m_dataStore = dataStore;
 	m_settings = settings;
-	m_versionName = versionName;
+	m_sessionPool = sessionPool;
+	m_contentCache = contentCache;
+	m_resultCache = resultCache;
+	m_journal = journal;
+	m_versionName.swap(versionName);
 }
 
 AnalyzeTask::~AnalyzeTask()
@@ -28,160 +69,417 @@ AnalyzeTask::~AnalyzeTask()
 
 void AnalyzeTask::run()
 {
-	// Just return if the file does not pass the file extension filters
-	if (!passesExtensionFilters())
+	// A version analyzed by an earlier run needs no cleartool at all
+	ResultCache::Entry cachedResult;
+
+	if (m_resultCache->find(m_versionName, cachedResult))
 	{
+		if (cachedResult.outcome == ResultCache::CHANGED ||
+			cachedResult.outcome == ResultCache::UNCHANGED)
+		{
+			FileDiff fileDiff(m_versionName);
+			fileDiff.populate(cachedResult.linesAdded,
+				cachedResult.linesChanged,
+				cachedResult.linesRemoved);
+
+			addDiff(cachedResult.createDate,
+				cachedResult.createTime,
+				cachedResult.user,
+				fileDiff);
+		}
+		else
+		{
+			m_journal->addSkipped(m_versionName);
+		}
+
 		return;
 	}
 
-	// Build a cleartool describe command to get the file information
-	String descCommand;
-	descCommand += "cleartool describe ";
-	descCommand += m_versionName;
-
-	// Execute the describe command in another process
-	Process descProcess;
-	descProcess.execCommand(descCommand, true);
-
-	InputStream* stdOutStream = descProcess.getStdOut();
-	TextReader descReader(stdOutStream);
-
-	// Read all the stdout and stderr
-	String descResult = descReader.readAll();
-
-	// Parse the description into a Description object
+	PooledSession session(m_sessionPool);
 	Description description;
 
-	try
+	if (!describe(description, session))
 	{
-		description.populate(m_versionName, descResult);
+		return;
 	}
-	catch (ParsingException& e)
+
+	// Skip invalid versions, symbolic links and directories
+	if (description.m_isInvalid)
 	{
-		cout << "Error: Failed to parse 'cleartool describe' result for \""
-			<< m_versionName << "\": " << e.what() << endl;
 		return;
 	}
 
-	// Skip invalid versions, symbolic links and directories
-	if (description.m_isInvalid ||
-		description.m_isSymbolicLink ||
-		description.m_isDirectory)
+	if (description.m_isSymbolicLink)
 	{
+		cacheResult(ResultCache::SYMBOLIC_LINK, description, NULL);
+		m_journal->addSkipped(m_versionName);
 		return;
 	}
 
-	String traceMessage = String("Analyzing: ") + m_versionName + '\n';
+	if (description.m_isDirectory)
+	{
+		cacheResult(ResultCache::DIRECTORY, description, NULL);
+		m_journal->addSkipped(m_versionName);
+		return;
+	}
+
+	String traceMessage("Analyzing: ");
+	traceMessage.append(m_versionName);
+	traceMessage.append('\n');
 	cout << traceMessage;
 
 	// Analyze other files.
-	analyzeFile(description);
+	analyzeFile(description, session);
 }
 
-bool AnalyzeTask::passesExtensionFilters()
+bool AnalyzeTask::isCached()
 {
-	// Ignore zero versions of files
-	if (m_versionName.endsWith("\\0") ||
-		m_versionName.endsWith("/0"))
+	ResultCache::Entry cachedResult;
+	return m_resultCache->find(m_versionName, cachedResult);
+}
+
+void AnalyzeTask::setDescriptionRecord(String& descriptionRecord)
+{
+	m_descriptionRecord.swap(descriptionRecord);
+}
+
+bool AnalyzeTask::hasDescriptionRecord()
+{
+	return (m_descriptionRecord.length() > 0);
+}
+
+const String& AnalyzeTask::getVersionName() const
+{
+	return m_versionName;
+}
+
+bool AnalyzeTask::describe(Description& description, PooledSession& session)
+{
+	// Use the record from the find if there is one, otherwise ask cleartool
+	// to describe the version
+	String descResult;
+
+	if (m_descriptionRecord.length() == 0)
 	{
-		return false;
+		// Build a cleartool describe command to get the file information
+		String descCommand;
+		descCommand += "describe \"";
+		descCommand += m_versionName;
+		descCommand += '\"';
+
+		// Read all the stdout and stderr from this worker's cleartool session
+		session->execute(descCommand, descResult);
 	}
 
-	// Ignore checked out files
-	if (m_versionName.endsWith("CHECKEDOUT"))
+	// Parse the description into a Description object
+	try
 	{
-		cout << "2" << endl;
+		if (m_descriptionRecord.length() == 0)
+		{
+			description.populate(m_versionName, descResult);
+		}
+		else
+		{
+			description.populateFromRecord(m_descriptionRecord);
+		}
+	}
+	catch (ParsingException& e)
+	{
+		cout << "Error: Failed to parse 'cleartool describe' result for \""
+			<< m_versionName << "\": " << e.what() << endl;
 		return false;
 	}
 
-	// Find the index of @@ which indicates the end of the "real" file name
-	int atatIndex = m_versionName.indexOf("@@");
+	return true;
+}
+
+void AnalyzeTask::analyzeFile(Description& description, PooledSession& session)
+{
+	FileDiff fileDiff(m_versionName);
+	ResultCache::Outcome outcome;
+	bool diffed;
+
+	// -localdiff has to know the predecessor to read it. If it can't be
+	// worked out, cleartool finds it and does the diff instead.
+	String predecessorName;
+
+	if (m_settings->getLocalDiff() &&
+		getPredecessorName(description, predecessorName))
+	{
+		diffed = diffLocally(predecessorName, fileDiff, outcome);
+	}
+	else
+	{
+		diffed = diffWithCleartool(description, session, fileDiff, outcome);
+	}
+
+	if (!diffed)
+	{
+		return;
+	}
+
+	cacheResult(outcome, description, &fileDiff);
 
-	if (atatIndex < 0)
+	if (outcome == ResultCache::BINARY)
 	{
-		cout << "No @@ in version: " << m_versionName << " possible error." << endl;
-		return false;
+		m_journal->addSkipped(m_versionName);
+		return;
 	}
 
-	vector<String> extensions = m_settings->getExtensions();
+	addDiff(description.m_createDate,
+		description.m_createTime,
+		description.m_user,
+		fileDiff);
+}
 
-	// If no extension parameters, accept any extension
-	if (extensions.size() == 0)
+void AnalyzeTask::addDiff(const String& createDate,
+						  const String& createTime,
+						  const String& user,
+						  FileDiff& fileDiff)
+{
+	// Convert the ISO date to a Date object
+	bool dateParsed;
+	Date date = parseDate(createDate,
+		createTime,
+		m_dataStore->getUtcOffsets(),
+		dateParsed);
+
+	if (!dateParsed)
 	{
-		return true;
+		cout << "Failed to convert ISO 8601 date in cleartool describe result "
+			"to unix time for version: " << m_versionName << endl;
+		return;
 	}
 
+	// Skip versions counted by an earlier -incremental run
+	if (!m_dataStore->claimVersion(createDate + 'T' + createTime))
+	{
+		return;
+	}
 
-	// Check for a valid extension
-	for (uint32 i = 0; i < extensions.size(); i++)
+	// Add the file's diff information to the data store. Don't bother
+	// with empty changes.
+	if (fileDiff.getLinesAdded() > 0 ||
+		fileDiff.getLinesChanged() > 0 ||
+		fileDiff.getLinesRemoved() > 0)
 	{
-		String extension = extensions[i];
-		String filePart = m_versionName.subString(0, atatIndex);
+		m_dataStore->addData(date, fileDiff, user);
+	}
 
-		if (filePart.endsWith(extension))
-			return true;
+	// Only once it's counted can a resumed run skip it
+	m_journal->add(m_versionName, createDate, createTime, user, fileDiff);
+}
+
+void AnalyzeTask::cacheResult(ResultCache::Outcome outcome,
+							  Description& description,
+							  FileDiff* fileDiff)
+{
+	ResultCache::Entry entry;
+	entry.outcome = outcome;
+	entry.createDate = description.m_createDate;
+	entry.createTime = description.m_createTime;
+	entry.user = description.m_user;
+	entry.predecessor = description.m_predecessor;
+	entry.mergeTo = description.m_mergeTo;
+	entry.linesAdded = 0;
+	entry.linesChanged = 0;
+	entry.linesRemoved = 0;
+
+	if (fileDiff != NULL)
+	{
+		entry.linesAdded = fileDiff->getLinesAdded();
+		entry.linesChanged = fileDiff->getLinesChanged();
+		entry.linesRemoved = fileDiff->getLinesRemoved();
 	}
 
-	return false;
+	m_resultCache->add(m_versionName, entry);
 }
 
-void AnalyzeTask::analyzeFile(Description& description)
+bool AnalyzeTask::diffWithCleartool(Description& description,
+									PooledSession& session,
+									FileDiff& fileDiff,
+									ResultCache::Outcome& outcome)
 {
 	// Build a diff against the previous version
 	// Parameters:
 	// -diff_format - use unix style diff format
+	// -headers_only - leave out the changed lines, only the ranges count
 	// -pred - compare against previous file version
 	// -blank_ignore - ignore pure white space changes
-	String diffCommand("cleartool diff -diff_format -pred ");
-	diffCommand.append(m_versionName);
+	String diffCommand("diff -diff_format ");
 
-	// Execute the diff command in another process
-	Process diffProcess;
-	diffProcess.execCommand(diffCommand, true);
+	if (m_settings->getHeadersOnly())
+	{
+		diffCommand.append("-headers_only ");
+	}
 
-	InputStream* stdOutStream = diffProcess.getStdOut();
-	TextReader diffReader(stdOutStream);
+	// Naming both versions saves cleartool looking up the predecessor.
+	// Only if it isn't known is -pred left to find it.
+	String predecessorName;
 
-	// Read all of stdout and stderr
-	String diffResult = diffReader.readAll();
+	if (getPredecessorName(description, predecessorName))
+	{
+		diffCommand.append('\"');
+		diffCommand.append(predecessorName);
+		diffCommand.append("\" \"");
+	}
+	else
+	{
+		diffCommand.append("-pred \"");
+	}
+
+	diffCommand.append(m_versionName);
+	diffCommand.append('\"');
+
+	// Count stdout and stderr as they are read, so even a huge diff is
+	// never held in memory. The exit status is ignored as diff returns
+	// non-zero whenever the versions differ.
+	DiffCounter diffCounter;
 
-	// Don't bother with empty changes
-	if (diffResult.length() == 0)
+	try
 	{
-		return;
+		session->execute(diffCommand, diffCounter);
+	}
+	catch (SystemException&)
+	{
+		// cleartool died part way through the output. Count it again from
+		// the start with a new cleartool.
+		diffCounter.reset();
+		session->execute(diffCommand, diffCounter);
 	}
 
-	// Parse the diff into a FileDiff object
-	FileDiff fileDiff(m_versionName);
+	// No output means no changes
+	if (diffCounter.isEmpty())
+	{
+		outcome = ResultCache::UNCHANGED;
+		return true;
+	}
 
+	// Put the counts into the FileDiff object
 	try
 	{
-		fileDiff.populate(diffResult);
+		fileDiff.populate(diffCounter);
 	}
 	catch (ParsingException& e)
 	{
 		cout << "Error: Failed to parse 'cleartood diff' result for \"" << m_versionName
 			<< "\" against its predecessor: " << e.what() << endl;
-		return;
+		return false;
 	}
 
-	// Convert the ISO date to a Date object
-	bool dateParsed;
-	Date date = parseDate(description.m_createDate, description.m_createTime, dateParsed);
+	outcome = ResultCache::CHANGED;
+	return true;
+}
 
-	if (!dateParsed)
+bool AnalyzeTask::diffLocally(const String& predecessorName,
+							  FileDiff& fileDiff,
+							  ResultCache::Outcome& outcome)
+{
+	String prevText;
+	String curText;
+
+	if (!readVersion(predecessorName, prevText) ||
+		!readVersion(m_versionName, curText))
 	{
-		cout << "Failed to convert ISO 8601 date in cleartool describe result "
-			"to unix time for version: " << m_versionName << endl;
-		return;
+		return false;
 	}
 
-	// Add the file's diff information to the data store
-	m_dataStore->addData(date, fileDiff);
+	// cleartool diff can't compare binary files either
+	if (memchr(prevText.c_str(), '\0', prevText.length()) != NULL ||
+		memchr(curText.c_str(), '\0', curText.length()) != NULL)
+	{
+		cout << "Skipping binary version: " << m_versionName << endl;
+		outcome = ResultCache::BINARY;
+		return true;
+	}
+
+	// Keep this version's text for when it is the predecessor of the next
+	m_contentCache->put(m_versionName, curText);
+
+	fileDiff.populate(prevText, curText);
+
+	if (fileDiff.getLinesAdded() > 0 ||
+		fileDiff.getLinesChanged() > 0 ||
+		fileDiff.getLinesRemoved() > 0)
+	{
+		outcome = ResultCache::CHANGED;
+	}
+	else
+	{
+		outcome = ResultCache::UNCHANGED;
+	}
+
+	return true;
 }
 
-Date AnalyzeTask::parseDate(String date, String time, bool& success)
+bool AnalyzeTask::getPredecessorName(Description& description, String& predecessorName)
 {
+	VersionName versionName;
+
+	if (!versionName.parse(m_versionName))
+	{
+		return false;
+	}
+
+	// The predecessor is on the same element, so when the description
+	// names it only the version part of the extended name changes. That
+	// also covers a version whose previous number was removed.
+	if (description.m_predecessor.length() > 0)
+	{
+		StringView element = versionName.getElement();
+		predecessorName.assign(element.data(), element.length());
+		predecessorName.append("@@");
+		predecessorName.append(description.m_predecessor);
+		return true;
+	}
+
+	// Otherwise it is the previous version on the same branch. A zero
+	// version's predecessor is on another branch and has to come from the
+	// VOB.
+	return versionName.getPredecessor(predecessorName);
+}
+
+bool AnalyzeTask::readVersion(const String& versionName, String& contents)
+{
+	// A predecessor is usually still cached from the comparison before
+	if (m_contentCache->get(versionName, contents))
+	{
+		return true;
+	}
+
+	try
+	{
+		FileInputStream file;
+		file.open(versionName);
+
+		uint32 length = contents.length();
+		int64 bytesRead;
+
+		// Read straight into the end of contents, which grows geometrically,
+		// rather than copying through a buffer on the stack
+		while ((bytesRead = file.read(contents.extend(READ_BUFFER_SIZE),
+									  READ_BUFFER_SIZE)) > 0)
+		{
+			length += (uint32)bytesRead;
+			contents.setLength(length);
+		}
+
+		contents.setLength(length);
+	}
+	catch (IOException& e)
+	{
+		cout << "Error: Failed to read \"" << versionName.c_str() << "\": "
+			<< e.what() << endl;
+		return false;
+	}
+
+	return true;
+}
+
+Date AnalyzeTask::parseDate(const String& date, const String& time, UtcOffsetTable& utcOffsets, bool& success)
+{
+	const char* datePart = date.c_str();
+	const char* timePart = time.c_str();
 	uint32 year;
 	uint32 month;
 	uint32 day;
@@ -189,68 +487,143 @@ Date AnalyzeTask::parseDate(String date, String time, bool& success)
 	uint32 min;
 	uint32 sec;
 
-	// Verify the fixed format YYYY-MM-DD
-	uint32 dash1 = date.indexOf('-');
-	uint32 dash2 = date.indexOf('-', dash1+1);
+	success = false;
 
-	if (dash1 != 4 || dash2 != 7)
+	// Verify the fixed format YYYY-MM-DD
+	if (date.length() != 10 ||
+		datePart[4] != '-' ||
+		datePart[7] != '-' ||
+		!parseDigits(datePart, 4, year) ||
+		!parseDigits(datePart + 5, 2, month) ||
+		!parseDigits(datePart + 8, 2, day))
 	{
-		success = false;
 		return Date();
 	}
 
-	// Extract substrings
-	String yearPart = date.subString(0, 4);
-	String monthPart = date.subString(5, 7);
-	String dayPart = date.subString(8, 10);
-
-	bool yearIsInt = true;
-	bool monthIsInt = true;
-	bool dayIsInt = true;
-	year = yearPart.toUInt32(yearIsInt);
-	month = monthPart.toUInt32(monthIsInt) - 1; // mktime expects a zero based month
-	day = dayPart.toUInt32(dayIsInt);
+	// Verify the fixed format HH:MM:SS
+	if (time.length() < 8 ||
+		timePart[2] != ':' ||
+		timePart[5] != ':' ||
+		!parseDigits(timePart, 2, hour) ||
+		!parseDigits(timePart + 3, 2, min) ||
+		!parseDigits(timePart + 6, 2, sec))
+	{
+		return Date();
+	}
 
-	if (!yearIsInt ||
-		!monthIsInt ||
-		!dayIsInt)
+	// Allow for a leap second
+	if (month < 1 || month > 12 || day < 1 || day > 31 ||
+		hour > 23 || min > 59 || sec > 60)
 	{
-		success = false;
 		return Date();
 	}
 
-	// Verify the fixed format HH:MM:SS-NN (NN = milliseconds)
-	// Don't bother validating that the milliseconds are there
-	uint32 colon1 = time.indexOf(':');
-	uint32 colon2 = time.indexOf(':', colon1+1);
-	//unsigned int dash = time.indexOf('-', colon2+1);
+	// Skip any fraction of a second
+	uint32 index = 8;
 
-	if (colon1 != 2 || colon2 != 5 /*|| dash != 8*/)
+	if (timePart[index] == '.' || timePart[index] == ',')
 	{
-		success = false;
-		return Date();
+		index++;
+
+		while (isdigit(timePart[index]))
+		{
+			index++;
+		}
 	}
 
-	// Extract substrings
-	String hourPart = time.subString(0, 2);
-	String minPart = time.subString(3, 5);
-	String secPart = time.subString(6, 8);
+	// The time as if it were UTC. The hour is zero based already, unlike
+	// the month.
+	time_t civilTime = (time_t)Date::daysFromCivil(year, month - 1, day) * 86400 +
+		hour * 3600 + min * 60 + sec;
 
-	bool hourIsInt = true;
-	bool minIsInt = true;
-	bool secIsInt = true;
-	hour = hourPart.toUInt32(hourIsInt) - 1; // mktime expects a zero based hour
-	min = minPart.toUInt32(minIsInt);
-	sec = secPart.toUInt32(secIsInt);
+	// Without an offset all that can be done is to assume local time
+	if (index == time.length())
+	{
+		success = true;
+		return Date(utcOffsets.getUnixTime(civilTime));
+	}
+
+	int32 offset;
 
-	if (!hourIsInt ||
-		!minIsInt ||
-		!secIsInt)
+	if (!parseUtcOffset(timePart + index, time.length() - index, offset))
 	{
-		success = false;
 		return Date();
 	}
 
 	success = true;
-	return Date(year, month, day, hour, min, sec);
+	return Date(civilTime - offset);
+}
+
+bool AnalyzeTask::parseDigits(const char* text, uint32 count, uint32& value)
+{
+	value = 0;
+
+	for (uint32 i = 0; i < count; i++)
+	{
+		if (!isdigit(text[i]))
+		{
+			return false;
+		}
+
+		value = value * 10 + (text[i] - '0');
+	}
+
+	return true;
+}
+
+bool AnalyzeTask::parseUtcOffset(const char* text, uint32 length, int32& offset)
+{
+	if (length == 1 && text[0] == 'Z')
+	{
+		offset = 0;
+		return true;
+	}
+
+	if (length < 2 || (text[0] != '+' && text[0] != '-'))
+	{
+		return false;
+	}
+
+	// Hours may be one digit or two, as in -7:00 and -07:00
+	uint32 hourLength = (length > 2 && isdigit(text[2])) ? 2 : 1;
+	uint32 hours;
+	uint32 minutes = 0;
+
+	if (!parseDigits(text + 1, hourLength, hours))
+	{
+		return false;
+	}
+
+	uint32 index = 1 + hourLength;
+
+	// The minutes are optional, with or without a colon
+	if (index < length && text[index] == ':')
+	{
+		index++;
+
+		if (index == length)
+		{
+			return false;
+		}
+	}
+
+	if (index < length &&
+		(length - index != 2 || !parseDigits(text + index, 2, minutes)))
+	{
+		return false;
+	}
+
+	if (hours > 23 || minutes > 59)
+	{
+		return false;
+	}
+
+	offset = (int32)(hours * 3600 + minutes * 60);
+
+	if (text[0] == '-')
+	{
+		offset = -offset;
+	}
+
+	return true;
 }
@@ -5,16 +5,24 @@
 
 #include <ccsponge.h>
 #include <Settings.h>
+#include <clearcase/CleartoolSessionPool.h>
+#include <clearcase/ContentCache.h>
 #include <clearcase/DataStore.h>
 #include <clearcase/Description.h>
 #include <clearcase/FileDiff.h>
+#include <clearcase/ProgressJournal.h>
+#include <clearcase/ResultCache.h>
 #include <text/String.h>
 #include <thread/ThreadPool.h>
 #include <util/Runnable.h>
 
 /*
  * Runnable that checks if the given version passes the user filters and,
- * if it passes, does a diff against the version's predessesor.
+ * if it passes, does a diff against the version's predessesor. The diff is
+ * run by cleartool, or with -localdiff by reading both versions directly.
+ *
+ * The version name and description record passed in are taken over by the
+ * task rather than copied, and are left empty.
  */
 class AnalyzeTask : public Runnable
 {
@@ -22,20 +30,94 @@ public:
 	AnalyzeTask(ThreadPool* threadPool,
 				DataStore* dataStore,
 				Settings* settings,
+				CleartoolSessionPool* sessionPool,
+				ContentCache* contentCache,
+				ResultCache* resultCache,
+				ProgressJournal* journal,
 				String& versionName);
+
+	/*
+	 * Creates a task for a version that cleartool has already described
+	 * with a DESCRIPTION_FORMAT record, so no describe needs to be run.
+	 */
+	AnalyzeTask(ThreadPool* threadPool,
+				DataStore* dataStore,
+				Settings* settings,
+				CleartoolSessionPool* sessionPool,
+				ContentCache* contentCache,
+				ResultCache* resultCache,
+				ProgressJournal* journal,
+				String& versionName,
+				String& descriptionRecord);
 	~AnalyzeTask();
 
 	void run();
 
+	/*
+	 * Supplies a DESCRIPTION_FORMAT record so run() doesn't have to
+	 * describe the version itself.
+	 */
+	void setDescriptionRecord(String& descriptionRecord);
+
+	bool hasDescriptionRecord();
+
+	/*
+	 * Returns true if the result for the version is in the ResultCache, so
+	 * run() won't need a description.
+	 */
+	bool isCached();
+
+	const String& getVersionName() const;
+
+	/*
+	 * Converts the ISO 8601 date and time of a description to a Date. The
+	 * date is YYYY-MM-DD and the time HH:MM:SS, optionally followed by a
+	 * fraction of a second and a UTC offset ("Z", "-07", "-0700" or
+	 * "-07:00"). The Date is worked out arithmetically without taking the
+	 * C library's time zone lock. Without an offset the time is taken to
+	 * be local time, and its offset is looked up in utcOffsets.
+	 */
+	static Date parseDate(const String& date, const String& time, UtcOffsetTable& utcOffsets, bool& success);
+
 private:
-	bool passesExtensionFilters();
-	void analyzeFile(Description& description);
-	static Date parseDate(String date, String time, bool& success);
+	void init(ThreadPool* threadPool,
+			  DataStore* dataStore,
+			  Settings* settings,
+			  CleartoolSessionPool* sessionPool,
+			  ContentCache* contentCache,
+			  ResultCache* resultCache,
+			  ProgressJournal* journal,
+			  String& versionName);
+	bool describe(Description& description, PooledSession& session);
+	void analyzeFile(Description& description, PooledSession& session);
+	void addDiff(const String& createDate,
+				 const String& createTime,
+				 const String& user,
+				 FileDiff& fileDiff);
+	void cacheResult(ResultCache::Outcome outcome,
+					 Description& description,
+					 FileDiff* fileDiff);
+	bool diffWithCleartool(Description& description,
+						   PooledSession& session,
+						   FileDiff& fileDiff,
+						   ResultCache::Outcome& outcome);
+	bool diffLocally(const String& predecessorName,
+					 FileDiff& fileDiff,
+					 ResultCache::Outcome& outcome);
+	bool getPredecessorName(Description& description, String& predecessorName);
+	bool readVersion(const String& versionName, String& contents);
+	static bool parseDigits(const char* text, uint32 count, uint32& value);
+	static bool parseUtcOffset(const char* text, uint32 length, int32& offset);
 
 	ThreadPool* m_threadPool;
 	DataStore* m_dataStore;
 	Settings* m_settings;
+	CleartoolSessionPool* m_sessionPool;
+	ContentCache* m_contentCache;
+	ResultCache* m_resultCache;
+	ProgressJournal* m_journal;
 	String m_versionName;
+	String m_descriptionRecord;
 };
 
 #endif // ANALYZE_TASK_H
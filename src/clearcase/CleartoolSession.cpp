@@ -0,0 +1,286 @@
+// CleartoolSession.cpp
+
+#include "CleartoolSession.h"
+#include <exception/SystemException.h>
+#include <io/OutputStream.h>
+#include <io/StringOutputStream.h>
+#include <util/Array.h>
+
+#include <ctype.h> // For isdigit()
+#include <string.h> // For memcmp() and strlen()
+
+// The prompt an interactive cleartool may print before reading a command
+#define PROMPT_TEXT "cleartool> "
+
+// The sentinel -status prints after each command:
+// Command 12 returned status 0
+#define STATUS_START "Command "
+#define STATUS_MIDDLE " returned status "
+
+
+CleartoolSession::CleartoolSession()
+{
+	m_process = NULL;
+	m_reader = NULL;
+	m_commandNumber = 0;
+}
+
+CleartoolSession::~CleartoolSession()
+{
+	stop();
+}
+
+int32 CleartoolSession::execute(const String& command, String& output)
+{
+	uint32 originalLength = output.length();
+	StringOutputStream outputStream(&output);
+	int32 status = 0;
+	bool wroteOutput = false;
+
+	if (m_process != NULL &&
+		tryExecute(command, outputStream, status, wroteOutput))
+	{
+		return status;
+	}
+
+	// Either the session was never started or cleartool died. Throw away
+	// any partial response and try again with a new process.
+	output.remove(originalLength, output.length() - originalLength);
+	stop();
+	start();
+
+	if (!tryExecute(command, outputStream, status, wroteOutput))
+	{
+		stop();
+		throw SystemException(String("cleartool session ended unexpectedly "
+			"while running: ") + command);
+	}
+
+	return status;
+}
+
+int32 CleartoolSession::execute(const String& command, OutputStream& output)
+{
+	int32 status = 0;
+	bool wroteOutput = false;
+
+	if (m_process != NULL &&
+		tryExecute(command, output, status, wroteOutput))
+	{
+		return status;
+	}
+
+	// Output already passed on can't be taken back, so only a session
+	// that died before answering can be retried
+	if (wroteOutput)
+	{
+		stop();
+		throw SystemException(String("cleartool session ended part way "
+			"through the output of: ") + command);
+	}
+
+	stop();
+	start();
+
+	if (!tryExecute(command, output, status, wroteOutput))
+	{
+		stop();
+		throw SystemException(String("cleartool session ended unexpectedly "
+			"while running: ") + command);
+	}
+
+	return status;
+}
+
+void CleartoolSession::stop()
+{
+	if (m_process == NULL)
+	{
+		return;
+	}
+
+	// Ask cleartool to exit. It may already be dead so failures are ignored.
+	try
+	{
+		writeCommand("quit");
+		m_process->getStdIn()->close();
+		m_process->waitFor();
+	}
+	catch (exception&)
+	{
+	}
+
+	delete m_reader;
+	delete m_process;
+	m_reader = NULL;
+	m_process = NULL;
+}
+
+// Private functions --------------------------------------------------------
+
+void CleartoolSession::start()
+{
+	// Run cleartool directly rather than through the shell. With no
+	// sub-command it reads commands from stdin until it gets "quit" or EOF.
+	Array<String> args(2);
+	args[0] = "cleartool";
+	args[1] = "-status";
+
+	m_process = new Process();
+
+	try
+	{
+		m_process->execProgram("cleartool", args, true);
+	}
+	catch (...)
+	{
+		delete m_process;
+		m_process = NULL;
+		throw;
+	}
+
+	m_reader = new BufferedReader(m_process->getStdOut());
+
+	// -status numbers the commands of each process from 1
+	m_commandNumber = 0;
+}
+
+bool CleartoolSession::tryExecute(const String& command,
+								  OutputStream& output,
+								  int32& status,
+								  bool& wroteOutput)
+{
+	if (!writeCommand(command))
+	{
+		return false;
+	}
+
+	m_commandNumber++;
+	bool firstLine = true;
+	uint32 promptLength = (uint32)strlen(PROMPT_TEXT);
+
+	while (true)
+	{
+		// The line points into the reader's buffer, so output is passed
+		// on without being copied
+		const char* line;
+		uint32 length;
+
+		// End of stream before the sentinel means cleartool died
+		if (!m_reader->readLine(line, length))
+		{
+			return false;
+		}
+
+		if (firstLine && length >= promptLength &&
+			memcmp(line, PROMPT_TEXT, promptLength) == 0)
+		{
+			line += promptLength;
+			length -= promptLength;
+		}
+
+		firstLine = false;
+
+		// Output that doesn't end in a newline shares a line with the
+		// sentinel, so keep whatever was in front of it
+		bool isStatusLine = parseStatusLine(line, length, status);
+
+		if (length > 0)
+		{
+			output.write(line, length);
+			wroteOutput = true;
+		}
+
+		if (isStatusLine)
+		{
+			return true;
+		}
+
+		output.write("\n", 1);
+		wroteOutput = true;
+	}
+}
+
+bool CleartoolSession::writeCommand(const String& command)
+{
+	String line(command);
+	line.append('\n');
+
+	OutputStream* stdInStream = m_process->getStdIn();
+	const char* data = line.c_str();
+	uint32 remaining = line.length();
+
+	// Pipes may accept only part of a write
+	while (remaining > 0)
+	{
+		int64 written = stdInStream->write(data, remaining);
+
+		if (written < 0)
+		{
+			return false;
+		}
+
+		data += written;
+		remaining -= (uint32)written;
+	}
+
+	return true;
+}
+
+bool CleartoolSession::parseStatusLine(const char* line, uint32& length, int32& status)
+{
+	uint32 startLength = (uint32)strlen(STATUS_START);
+	uint32 middleLength = (uint32)strlen(STATUS_MIDDLE);
+
+	// Find the last "Command " in the line
+	int32 start = (int32)length - (int32)startLength;
+
+	while (start >= 0 && memcmp(line + start, STATUS_START, startLength) != 0)
+	{
+		start--;
+	}
+
+	// Part way along the line it can only follow output that didn't end
+	// in a newline, in which case it is the last thing cleartool printed
+	if (start < 0 || (start > 0 && m_reader->hasBufferedData()))
+	{
+		return false;
+	}
+
+	// The command number has to be the one just sent
+	uint32 index = start + startLength;
+	uint32 numberStart = index;
+	uint32 commandNumber = 0;
+
+	while (index < length && isdigit(line[index]))
+	{
+		commandNumber = commandNumber * 10 + (line[index] - '0');
+		index++;
+	}
+
+	if (index == numberStart || commandNumber != m_commandNumber ||
+		length - index < middleLength ||
+		memcmp(line + index, STATUS_MIDDLE, middleLength) != 0)
+	{
+		return false;
+	}
+
+	// The rest of the line has to be the status number
+	index += middleLength;
+	numberStart = index;
+	status = 0;
+
+	while (index < length && isdigit(line[index]))
+	{
+		status = status * 10 + (line[index] - '0');
+		index++;
+	}
+
+	if (index == numberStart || index != length)
+	{
+		return false;
+	}
+
+	length = start;
+	return true;
+}
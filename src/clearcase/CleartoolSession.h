@@ -0,0 +1,81 @@
+// CleartoolSession.h
+
+#ifndef CLEARTOOL_SESSION_H
+#define CLEARTOOL_SESSION_H
+
+#include <ccsponge.h>
+#include <io/BufferedReader.h>
+#include <io/OutputStream.h>
+#include <text/String.h>
+#include <thread/Process.h>
+
+/*
+ * A long-lived interactive cleartool process. Commands are written to the
+ * process's stdin one line at a time instead of starting a new cleartool
+ * for each command, which saves the cleartool start-up and VOB login cost.
+ *
+ * cleartool is started with the -status option, which makes it print a
+ * line like "Command 12 returned status 0" after every command. That line
+ * is used as the sentinel marking the end of each response. The commands
+ * are counted so only the sentinel with this command's number is taken,
+ * and only at the start of a line or straight after output that didn't end
+ * in a newline, as cleartool prints nothing more until the next command.
+ * Diff or comment text quoting a sentinel isn't mistaken for the end.
+ *
+ * If the cleartool process dies it is restarted on the next command.
+ *
+ * Not safe for access by multiple threads.
+ */
+class CleartoolSession
+{
+public:
+	CleartoolSession();
+	~CleartoolSession();
+
+	/*
+	 * Runs a single cleartool sub-command (without the leading "cleartool")
+	 * and appends everything it prints to output. Returns the exit status
+	 * cleartool reported for the command.
+	 *
+	 * If the session has died it is restarted and the command retried once.
+	 *
+	 * Throws SystemException if cleartool cannot be started or dies again
+	 * while running the retried command.
+	 */
+	int32 execute(const String& command, String& output);
+
+	/*
+	 * Same as above, but writes the output to outputStream as it is read
+	 * instead of collecting it, so output of any size takes no memory.
+	 *
+	 * Output that has been written can't be taken back, so if cleartool
+	 * dies after writing some the command isn't retried and
+	 * SystemException is thrown.
+	 */
+	int32 execute(const String& command, OutputStream& output);
+
+	/*
+	 * Ends the cleartool process. The next call to execute() will start a
+	 * new one.
+	 */
+	void stop();
+
+private:
+	CleartoolSession(const CleartoolSession& other) {}
+	CleartoolSession& operator=(const CleartoolSession& other) {}
+
+	void start();
+	bool tryExecute(const String& command,
+					OutputStream& output,
+					int32& status,
+					bool& wroteOutput);
+	bool writeCommand(const String& command);
+	bool parseStatusLine(const char* line, uint32& length, int32& status);
+
+private:
+	Process* m_process;
+	BufferedReader* m_reader;
+	uint32 m_commandNumber; // Of the last command sent to this process
+};
+
+#endif // CLEARTOOL_SESSION_H
@@ -0,0 +1,61 @@
+// CleartoolSessionPool.cpp
+
+#include "CleartoolSessionPool.h"
+#include <util/Locker.h>
+
+CleartoolSessionPool::CleartoolSessionPool()
+{
+
+}
+
+CleartoolSessionPool::~CleartoolSessionPool()
+{
+	Locker locker(m_mutex);
+
+	for (uint32 i = 0; i < m_idle.size(); i++)
+	{
+		delete m_idle.at(i);
+	}
+	m_idle.clear();
+}
+
+CleartoolSession* CleartoolSessionPool::acquire()
+{
+	{
+		Locker locker(m_mutex);
+
+		if (m_idle.size() > 0)
+		{
+			CleartoolSession* session = m_idle.back();
+			m_idle.pop_back();
+			return session;
+		}
+	}
+
+	// The cleartool process itself is started lazily by the first command
+	return new CleartoolSession();
+}
+
+void CleartoolSessionPool::release(CleartoolSession* session)
+{
+	Locker locker(m_mutex);
+	m_idle.push_back(session);
+}
+
+// PooledSession ------------------------------------------------------------
+
+PooledSession::PooledSession(CleartoolSessionPool* pool)
+{
+	m_pool = pool;
+	m_session = pool->acquire();
+}
+
+PooledSession::~PooledSession()
+{
+	m_pool->release(m_session);
+}
+
+CleartoolSession* PooledSession::operator->()
+{
+	return m_session;
+}
@@ -0,0 +1,76 @@
+// CleartoolSessionPool.h
+
+#ifndef CLEARTOOL_SESSION_POOL_H
+#define CLEARTOOL_SESSION_POOL_H
+
+#include <clearcase/CleartoolSession.h>
+#include <thread/Mutex.h>
+
+#include <vector>
+using namespace std;
+
+/*
+ * Hands out CleartoolSession objects to worker threads. A session is only
+ * ever used by the thread that acquired it, so the pool grows to one
+ * session per concurrently running worker and those sessions are reused
+ * for the rest of the run.
+ *
+ * All public functions are thread safe.
+ */
+class CleartoolSessionPool
+{
+public:
+	CleartoolSessionPool();
+
+	/*
+	 * Stops every session in the pool. Sessions still acquired by a
+	 * thread are not stopped, so release them first.
+	 */
+	~CleartoolSessionPool();
+
+	/*
+	 * Returns an idle session, creating one if there are none. The session
+	 * must be handed back with release().
+	 */
+	CleartoolSession* acquire();
+
+	/*
+	 * Returns a session obtained from acquire() to the pool.
+	 */
+	void release(CleartoolSession* session);
+
+private:
+	CleartoolSessionPool(const CleartoolSessionPool& other) {}
+	CleartoolSessionPool& operator=(const CleartoolSessionPool& other) {}
+
+private:
+	Mutex m_mutex;
+	vector<CleartoolSession*> m_idle;
+};
+
+/*
+ * Acquires a session from a CleartoolSessionPool in the constructor and
+ * releases it in the destructor, in the same way Locker does for a
+ * Lockable:
+ *
+ * PooledSession session(sessionPool);
+ * session->execute(command, output);
+ */
+class PooledSession
+{
+public:
+	PooledSession(CleartoolSessionPool* pool);
+	~PooledSession();
+
+	CleartoolSession* operator->();
+
+private:
+	PooledSession(const PooledSession& other) {}
+	PooledSession& operator=(const PooledSession& other) {}
+
+private:
+	CleartoolSessionPool* m_pool;
+	CleartoolSession* m_session;
+};
+
+#endif // CLEARTOOL_SESSION_POOL_H
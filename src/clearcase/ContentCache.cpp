@@ -0,0 +1,70 @@
+// ContentCache.cpp
+
+#include "ContentCache.h"
+#include <util/Locker.h>
+
+ContentCache::ContentCache(uint32 maxBytes)
+{
+	m_maxBytes = maxBytes;
+	m_usedBytes = 0;
+}
+
+ContentCache::~ContentCache()
+{
+
+}
+
+bool ContentCache::get(const String& versionName, String& contents)
+{
+	Locker locker(m_mutex);
+
+	map<String, CacheEntry>::iterator iter = m_entries.find(versionName);
+
+	if (iter == m_entries.end())
+	{
+		return false;
+	}
+
+	// Move to the front of the list as the most recently used
+	m_recentlyUsed.splice(m_recentlyUsed.begin(), m_recentlyUsed,
+		iter->second.position);
+
+	contents.assign(iter->second.contents);
+	return true;
+}
+
+void ContentCache::put(const String& versionName, const String& contents)
+{
+	Locker locker(m_mutex);
+
+	if (m_maxBytes == 0 ||
+		contents.length() > m_maxBytes ||
+		m_entries.find(versionName) != m_entries.end())
+	{
+		return;
+	}
+
+	while (m_usedBytes + contents.length() > m_maxBytes)
+	{
+		removeOldest();
+	}
+
+	m_recentlyUsed.push_front(versionName);
+
+	CacheEntry& entry = m_entries[versionName];
+	entry.contents.assign(contents);
+	entry.position = m_recentlyUsed.begin();
+
+	m_usedBytes += contents.length();
+}
+
+// Private functions --------------------------------------------------------
+
+void ContentCache::removeOldest()
+{
+	map<String, CacheEntry>::iterator iter = m_entries.find(m_recentlyUsed.back());
+
+	m_usedBytes -= iter->second.contents.length();
+	m_entries.erase(iter);
+	m_recentlyUsed.pop_back();
+}
@@ -0,0 +1,66 @@
+// ContentCache.h
+
+#ifndef CONTENT_CACHE_H
+#define CONTENT_CACHE_H
+
+#include <ccsponge.h>
+#include <text/String.h>
+#include <thread/Mutex.h>
+
+#include <list>
+#include <map>
+using namespace std;
+
+/*
+ * Holds the text of recently read versions, keyed by version extended
+ * name, so the version read for one -localdiff comparison can be reused as
+ * the predecessor in the comparison of the next version of the element.
+ *
+ * The cache is bounded by the total size of the text it holds. When it is
+ * full the least recently used versions are dropped first.
+ *
+ * All public functions are thread safe.
+ */
+class ContentCache
+{
+public:
+	/*
+	 * Creates a cache holding up to maxBytes of version text. A size of 0
+	 * disables the cache.
+	 */
+	ContentCache(uint32 maxBytes);
+	~ContentCache();
+
+	/*
+	 * Copies the cached text of the version to contents. Returns false if
+	 * the version isn't cached.
+	 */
+	bool get(const String& versionName, String& contents);
+
+	/*
+	 * Adds the text of a version, dropping older versions to make room.
+	 * Text larger than the whole cache is not stored.
+	 */
+	void put(const String& versionName, const String& contents);
+
+private:
+	ContentCache(const ContentCache& other) {}
+	ContentCache& operator=(const ContentCache& other) {}
+
+	struct CacheEntry
+	{
+		String contents;
+		list<String>::iterator position; // Place in m_recentlyUsed
+	};
+
+	void removeOldest();
+
+private:
+	Mutex m_mutex;
+	uint32 m_maxBytes;
+	uint32 m_usedBytes;
+	map<String, CacheEntry> m_entries;
+	list<String> m_recentlyUsed; // Most recently used first
+};
+
+#endif // CONTENT_CACHE_H
@@ -1,8 +1,8 @@
 // CtFindTask.cpp
 
 #include "CtFindTask.h"
+#include <io/BufferedReader.h>
 #include <io/InputStream.h>
-#include <io/TextReader.h>
 #include <thread/Process.h>
 #include <util/Array.h>
 
@@ -12,11 +12,20 @@ using namespace std;
 
 CtFindTask::CtFindTask(ThreadPool* threadPool,
 					   DataStore* dataStore,
-					   Settings* settings)
+					   Settings* settings,
+					   CleartoolSessionPool* sessionPool,
+					   ContentCache* contentCache,
+					   ResultCache* resultCache,
+					   ProgressJournal* journal) :
+	m_scheduler(threadPool, settings, sessionPool)
 {
 	m_threadPool = threadPool;
 	m_dataStore = dataStore;
 	m_settings = settings;
+	m_sessionPool = sessionPool;
+	m_contentCache = contentCache;
+	m_resultCache = resultCache;
+	m_journal = journal;
 }
 
 CtFindTask::~CtFindTask()
@@ -34,7 +43,7 @@ void CtFindTask::run()
 	findProcess.execCommand(command, true);
 
 	InputStream* stdOutStream = findProcess.getStdOut();
-	TextReader findReader(stdOutStream);
+	BufferedReader findReader(stdOutStream);
 	bool readSuccess;
 
 	// Extract the first returned version name
@@ -67,31 +76,57 @@ void CtFindTask::run()
 		exit(1);
 	}
 
-	AnalyzeTask* analyzeTask = new AnalyzeTask(m_threadPool,
-			m_dataStore,
-			m_settings,
-			versionName);
-	m_threadPool->execute(analyzeTask);
-
-	// Loop to analyze remaining versions
-	while (true)
-	{
-		versionName = findReader.readLine(readSuccess);
+	analyze(versionName);
 
-		if (!readSuccess)
-			break;
+	// Loop to analyze remaining versions. Each line is copied straight out
+	// of the reader's buffer into the String the AnalyzeTask takes over.
+	const char* data;
+	uint32 length;
 
-		analyzeTask = new AnalyzeTask(m_threadPool,
-			m_dataStore,
-			m_settings,
-			versionName);
-		m_threadPool->execute(analyzeTask);
+	while (findReader.readLine(data, length))
+	{
+		versionName.assign(data, length);
+		analyze(versionName);
 	}
 
+	// Send off the last partial batch
+	m_scheduler.flush();
+
 	// Wait for the find process to exit
 	findProcess.waitFor();
 }
 
+void CtFindTask::analyze(String& line)
+{
+	if ((int32)line.indexOf("@@") < 0)
+	{
+		cout << "No @@ in version: " << line << " possible error." << endl;
+		return;
+	}
+
+	if (!m_settings->getFilter().passes(line))
+	{
+		return;
+	}
+
+	// Already counted by the run being resumed
+	if (m_journal->contains(line))
+	{
+		return;
+	}
+
+	AnalyzeTask* analyzeTask = new AnalyzeTask(m_threadPool,
+		m_dataStore,
+		m_settings,
+		m_sessionPool,
+		m_contentCache,
+		m_resultCache,
+		m_journal,
+		line);
+
+	m_scheduler.add(analyzeTask);
+}
+
 String CtFindTask::makeQuery()
 {
 	vector<String> filters;
@@ -118,6 +153,10 @@ String CtFindTask::makeQuery()
 	if (afterDateFilter.length() > 0)
 		filters.push_back(afterDateFilter);
 
+	String incrementalFilter = makeIncrementalFilter();
+	if (incrementalFilter.length() > 0)
+		filters.push_back(incrementalFilter);
+
 	String excludeMergesFilter = makeExcludeMergesFilter();
 	if (excludeMergesFilter.length() > 0)
 		filters.push_back(excludeMergesFilter);
@@ -125,6 +164,7 @@ String CtFindTask::makeQuery()
 	// Build command string
 	String command("cleartool find ");
 	command.append(makeDirectoryList());
+	command.append(makeNameOption());
 	command.append(" -version ");
 	command.append(ARG_QUOTE_CHAR);
 
@@ -157,7 +197,7 @@ String CtFindTask::makeQuery()
 
 String CtFindTask::makeDirectoryList()
 {
-	vector<String> pathsArgs = m_settings->getPaths();
+	const vector<String>& pathsArgs = m_settings->getPaths();
 	String ret;
 
 	for (uint32 i = 0; i < pathsArgs.size(); i++)
@@ -170,9 +210,27 @@ String CtFindTask::makeDirectoryList()
 	return ret;
 }
 
+String CtFindTask::makeNameOption()
+{
+	// Have find skip elements the file name filters would throw away. The
+	// versions it does print are still filtered, so this only saves work.
+	String namePattern = m_settings->getFilter().getFindNamePattern();
+	String ret;
+
+	if (namePattern.length() == 0)
+		return ret;
+
+	ret.append(" -name ");
+	ret.append(ARG_QUOTE_CHAR);
+	ret.append(namePattern);
+	ret.append(ARG_QUOTE_CHAR);
+
+	return ret;
+}
+
 String CtFindTask::makeBranchFilter()
 {
-	vector<String> branchArgs = m_settings->getBrtypes();
+	const vector<String>& branchArgs = m_settings->getBrtypes();
 	String ret;
 
 	if (branchArgs.size() == 0)
@@ -213,7 +271,7 @@ String CtFindTask::makeExcludeMainFilter()
 
 String CtFindTask::makeUserFilter()
 {
-	vector<String> userArgs = m_settings->getUsers();
+	const vector<String>& userArgs = m_settings->getUsers();
 	String ret;
 
 	if (userArgs.size() == 0)
@@ -269,6 +327,22 @@ String CtFindTask::makeAfterDateFilter()
 	return ret;
 }
 
+String CtFindTask::makeIncrementalFilter()
+{
+	// Versions up to the high-water mark are already in the restored state
+	String sinceDate = m_dataStore->getSinceDate();
+	String ret;
+
+	if (sinceDate.length() == 0)
+		return ret;
+
+	ret.append("(created_since(");
+	ret.append(sinceDate);
+	ret.append("))");
+
+	return ret;
+}
+
 String CtFindTask::makeExcludeMergesFilter()
 {
 	bool excludeMerges = m_settings->getMergesExcluded();
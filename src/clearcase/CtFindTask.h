@@ -5,7 +5,12 @@
 
 #include <Settings.h>
 #include <clearcase/AnalyzeTask.h>
+#include <clearcase/CleartoolSessionPool.h>
+#include <clearcase/ContentCache.h>
 #include <clearcase/DataStore.h>
+#include <clearcase/ElementScheduler.h>
+#include <clearcase/ProgressJournal.h>
+#include <clearcase/ResultCache.h>
 #include <text/String.h>
 #include <thread/ThreadPool.h>
 #include <util/Runnable.h>
@@ -25,24 +30,36 @@ class CtFindTask : public Runnable
 public:
 	CtFindTask(ThreadPool* threadPool,
 			   DataStore* dataStore,
-			   Settings* settings);
+			   Settings* settings,
+			   CleartoolSessionPool* sessionPool,
+			   ContentCache* contentCache,
+			   ResultCache* resultCache,
+			   ProgressJournal* journal);
 	~CtFindTask();
 
 	void run();
 
 private:
+	void analyze(String& line);
 	String makeQuery();
 	String makeDirectoryList();
+	String makeNameOption();
 	String makeBranchFilter();
 	String makeExcludeMainFilter();
 	String makeUserFilter();
 	String makeBeforeDateFilter();
 	String makeAfterDateFilter();
+	String makeIncrementalFilter();
 	String makeExcludeMergesFilter();
 
 	ThreadPool* m_threadPool;
 	DataStore* m_dataStore;
 	Settings* m_settings;
+	CleartoolSessionPool* m_sessionPool;
+	ContentCache* m_contentCache;
+	ResultCache* m_resultCache;
+	ProgressJournal* m_journal;
+	ElementScheduler m_scheduler;
 };
 
 #endif // CT_FIND_TASK_H
@@ -17,6 +17,13 @@ DataEntry::DataEntry(FileDiff& fileDiff)
 	m_linesRemoved = fileDiff.getLinesRemoved();
 }
 
+DataEntry::DataEntry(uint32 linesAdded, uint32 linesChanged, uint32 linesRemoved)
+{
+	m_linesAdded = linesAdded;
+	m_linesChanged = linesChanged;
+	m_linesRemoved = linesRemoved;
+}
+
 DataEntry::~DataEntry()
 {
 
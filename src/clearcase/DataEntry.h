@@ -16,6 +16,7 @@ class DataEntry
 public:
 	DataEntry();
 	DataEntry(FileDiff& fileDiff);
+	DataEntry(uint32 linesAdded, uint32 linesChanged, uint32 linesRemoved);
 	~DataEntry();
 
 	void add(FileDiff& fileDiff);
@@ -1,214 +1,777 @@
 // DataStore.cpp
 
 #include "DataStore.h"
+#include <clearcase/VersionName.h>
+#include <exception/ParsingException.h>
+#include <io/BufferedReader.h>
+
+#include <string.h> // For strlen()
+
+// Keys of the header lines in the incremental state
+#define PERIOD_KEY "period\t"
+#define MARK_KEY "mark\t"
+
+// Length of a creation time like 2011-12-02T07:45:28
+#define MARK_LENGTH 19
+
+// Month abbreviations in cleartool dates like 02-Dec-2011
+const char* const monthNames[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun",
+	"Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+
+// Column headers of the -groupby reports, in Settings::dimension order
+const char* const dimensionHeaders[] = {"User", "Branch Type", "Extension",
+	"Directory"};
+
 
 DataStore::DataStore(Settings* settings)
 {
 	m_settings = settings;
+	m_firstBucket = 0;
 }
 
 DataStore::~DataStore()
 {
+	for (uint32 i = 0; i < m_shards.size(); i++)
+	{
+		delete m_shards[i];
+	}
+}
 
+void DataStore::addData(Date date, FileDiff& fileDiff, const String& user)
+{
+	Shard& shard = getShard();
+	int32 bucket = getBucket(date, shard.utcOffsets);
+
+	addToShard(shard,
+		bucket,
+		fileDiff.getLinesAdded(),
+		fileDiff.getLinesChanged(),
+		fileDiff.getLinesRemoved());
+
+	if (m_settings->getGroupBy().size() > 0)
+	{
+		addFact(shard, bucket, fileDiff, user);
+	}
 }
 
-void DataStore::addData(Date date, FileDiff& fileDiff)
+void DataStore::addData(Date date, DataEntry& dataEntry)
 {
-	Locker locker(m_mutex);
+	Shard& shard = getShard();
+
+	addToShard(shard,
+		getBucket(date, shard.utcOffsets),
+		dataEntry.getLinesAdded(),
+		dataEntry.getLinesChanged(),
+		dataEntry.getLinesRemoved());
+}
 
-	// Round down the date as appropriate to make a good key
-	date = roundDownDate(date);
+bool DataStore::claimVersion(const String& createdAt)
+{
+	// Leave off any UTC offset
+	String localTime(createdAt);
 
-	// Grab the existing entry if it already exists
-	map<Date, DataEntry>::iterator iter = m_dataMap.find(date);
+	if (localTime.length() > MARK_LENGTH)
+	{
+		localTime = createdAt.subString(0, MARK_LENGTH);
+	}
 
-	if (iter == m_dataMap.end())
+	// Anything up to the restored mark was counted by an earlier run. The
+	// mark is only set by readState(), before any versions are counted.
+	if (m_restoredMark.length() > 0 && localTime <= m_restoredMark)
 	{
-		// If there is no entry for the given time, add an entry
-		DataEntry dataEntry(fileDiff);
-		m_dataMap.insert(pair<Date, DataEntry>(date, dataEntry));
+		return false;
 	}
-	else
+
+	Shard& shard = getShard();
+
+	if (localTime > shard.highWaterMark)
 	{
-		// If an entry exists, then replace it with an entry that has the
-		// new data added to it
-		pair<Date, DataEntry> dataPair = *iter;
-		dataPair.second.add(fileDiff);
-		m_dataMap.erase(iter);
-		m_dataMap.insert(dataPair);
+		shard.highWaterMark = localTime;
 	}
+
+	return true;
 }
 
-void DataStore::addData(Date date, DataEntry& dataEntry)
+UtcOffsetTable& DataStore::getUtcOffsets()
+{
+	return getShard().utcOffsets;
+}
+
+String DataStore::getSinceDate()
 {
 	Locker locker(m_mutex);
 
-	// Round down the date as appropriate to make a good key
-	roundDownDate(date);
+	String ret;
 
-	// Grab the existing entry if it already exists
-	map<Date, DataEntry>::iterator iter = m_dataMap.find(date);
+	if (m_restoredMark.length() == 0)
+		return ret;
 
-	if (iter == m_dataMap.end())
+	// 2011-12-02T07:45:28 becomes 02-Dec-2011.07:45:28
+	bool isInt = true;
+	uint32 month = m_restoredMark.subString(5, 7).toUInt32(isInt);
+
+	ret.append(m_restoredMark.subString(8, 10));
+	ret.append('-');
+	ret.append(monthNames[month - 1]);
+	ret.append('-');
+	ret.append(m_restoredMark.subString(0, 4));
+	ret.append('.');
+	ret.append(m_restoredMark.subString(11));
+
+	return ret;
+}
+
+void DataStore::readState(InputStream& inputStream)
+{
+	Locker locker(m_mutex);
+
+	BufferedReader reader(&inputStream);
+	bool readSuccess;
+
+	// The period line. Buckets of one period can't be split into another.
+	String line = reader.readLine(readSuccess);
+	String periodName = getPeriodName(m_settings->getPeriod());
+
+	if (!readSuccess || !line.startsWith(PERIOD_KEY))
+	{
+		throw ParsingException("Missing period in incremental state");
+	}
+
+	if (!line.subString((uint32)strlen(PERIOD_KEY)).equals(periodName))
+	{
+		throw ParsingException(String("Incremental state was kept for a "
+			"different period than ") + periodName);
+	}
+
+	// The creation time of the newest version counted, if any
+	line = reader.readLine(readSuccess);
+	uint32 markLength = line.length() - (uint32)strlen(MARK_KEY);
+
+	if (!readSuccess || !line.startsWith(MARK_KEY) ||
+		(markLength != 0 && markLength != MARK_LENGTH))
 	{
-		// If there is no entry for the given time, add an entry
-		m_dataMap.insert(pair<Date, DataEntry>(date, dataEntry));
+		throw ParsingException("Missing high-water mark in incremental state");
 	}
-	else
+
+	m_restoredMark = line.subString((uint32)strlen(MARK_KEY));
+
+	if (markLength != 0)
+	{
+		bool isInt = true;
+		uint32 month = m_restoredMark.subString(5, 7).toUInt32(isInt);
+
+		if (!isInt || month < 1 || month > 12)
+		{
+			throw ParsingException(String("Bad high-water mark in "
+				"incremental state: ") + m_restoredMark);
+		}
+	}
+
+	m_highWaterMark = m_restoredMark;
+
+	// One line per bucket
+	while (true)
 	{
-		// If an entry exists, then add the new data to it
-		pair<Date, DataEntry> pair = *iter;
-		DataEntry existingEntry = pair.second;
-		existingEntry.add(dataEntry);
+		line = reader.readLine(readSuccess);
+
+		if (!readSuccess)
+			break;
+
+		if (line.length() == 0)
+			continue;
+
+		CivilDate day;
+		DataEntry dataEntry;
+
+		if (!parseBucket(line, day, dataEntry))
+		{
+			throw ParsingException(String("Bad bucket in incremental state: ")
+				+ line);
+		}
+
+		getEntry(getBucket(day)).add(dataEntry);
+	}
+}
+
+void DataStore::writeState(OutputStream& outputStream)
+{
+	Locker locker(m_mutex);
+	mergeShards();
+
+	String state(PERIOD_KEY);
+	state.append(getPeriodName(m_settings->getPeriod()));
+	state.append('\n');
+
+	// Empty if nothing has been counted yet
+	state.append(MARK_KEY);
+	state.append(m_highWaterMark);
+	state.append('\n');
+
+	for (uint32 i = 0; i < m_buckets.size(); i++)
+	{
+		DataEntry& entry = m_buckets[i];
+
+		// Empty buckets in between come back as the run is filled in, but
+		// the first and last are kept as they mark where it starts and ends
+		if (entry.getLinesAdded() == 0 &&
+			entry.getLinesChanged() == 0 &&
+			entry.getLinesRemoved() == 0 &&
+			i != 0 && i != m_buckets.size() - 1)
+		{
+			continue;
+		}
+
+		state.append(getBucketStart(m_firstBucket + i).toIsoString());
+		state.append('\t');
+		state.append(entry.getLinesAdded());
+		state.append('\t');
+		state.append(entry.getLinesChanged());
+		state.append('\t');
+		state.append(entry.getLinesRemoved());
+		state.append('\n');
 	}
+
+	outputStream.write(state.c_str(), state.length());
 }
 
 void DataStore::writeToStream(OutputStream& outputStream)
 {
 	Locker locker(m_mutex);
+	mergeShards();
 
 	// Print the header line
 	String header("Date,Lines Added,Lines Changed,Lines Removed,Total Lines\n");
 	outputStream.write(header.c_str(), header.length());
 
-	Date prevDate(0);
-	map<Date, DataEntry>::iterator iter = m_dataMap.begin();
+	// Every bucket between the first and last is already there, with
+	// zeroed data where nothing was added
+	for (uint32 i = 0; i < m_buckets.size(); i++)
+	{
+		String row = getRow(getBucketStart(m_firstBucket + i), m_buckets[i]);
+		outputStream.write(row.c_str(), row.length());
+	}
+}
+
+void DataStore::writeGroupToStream(Settings::dimension dimension, OutputStream& outputStream)
+{
+	Locker locker(m_mutex);
+
+	// A value has a different ID in each shard, so the shards' facts are
+	// summed up by the value itself
+	map<pair<int32, String>, DataEntry> rows;
 
-	// Print out each DataEntry
-	while (iter != m_dataMap.end())
+	for (uint32 i = 0; i < m_shards.size(); i++)
 	{
-		// Extract the next entry
-		pair<Date, DataEntry> pair = *iter;
-		Date entryDate = pair.first;
-		DataEntry entry = pair.second;
+		Shard& shard = *m_shards[i];
+		map<FactKey, DataEntry>::iterator factIter;
 
-		// Before we write it to the stream, Fill in missing dates between
-		// entries with zeroed data. For example, if this entry was 2 months
-		// after the last one, fill in the empty months.
-		if (prevDate != 0)
+		for (factIter = shard.facts.begin(); factIter != shard.facts.end(); factIter++)
 		{
-			vector<Date> missingDates = getMissingDates(prevDate, entryDate);
-
-			for (uint32 i = 0; i < missingDates.size(); i++)
-			{
-				Date missingDate = missingDates.at(i);
-				String emptyRow = getEmptyRow(missingDate);
-				outputStream.write(emptyRow.c_str(), emptyRow.length());
-			}
+			const FactKey& key = factIter->first;
+			pair<int32, String> rowKey(key.bucket, shard.values[key.valueIds[dimension]]);
+			rows[rowKey].add(factIter->second);
 		}
+	}
 
-		// Write it to the stream
-		String row = getRow(entryDate, entry);
-		outputStream.write(row.c_str(), row.length());
+	// Print the header line
+	String header("Date,");
+	header.append(dimensionHeaders[dimension]);
+	header.append(",Lines Added,Lines Changed,Lines Removed,Total Lines\n");
+	outputStream.write(header.c_str(), header.length());
 
-		prevDate = entryDate;
-		iter++;
+	// Only the values with data in a period get a row for it
+	map<pair<int32, String>, DataEntry>::iterator rowIter;
+
+	for (rowIter = rows.begin(); rowIter != rows.end(); rowIter++)
+	{
+		String row = getBucketStart(rowIter->first.first).toIsoString();
+		row.append(",");
+		row.append(quoteCsvField(rowIter->first.second));
+		row.append(getCounts(rowIter->second));
+		outputStream.write(row.c_str(), row.length());
 	}
 }
 
 // Private functions --------------------------------------------------------
 
-String DataStore::getRow(Date date, DataEntry& dataEntry)
+bool DataStore::FactKey::operator<(const FactKey& other) const
 {
-	String formattedDate = getIsoDate(date);
-	uint32 added = dataEntry.getLinesAdded();
-	uint32 changed = dataEntry.getLinesChanged();
-	uint32 removed = dataEntry.getLinesRemoved();
+	if (bucket != other.bucket)
+	{
+		return (bucket < other.bucket);
+	}
 
-	String ret;
-	ret.append(formattedDate);
-	ret.append(",");
-	ret.append(added);
-	ret.append(",");
-	ret.append(changed);
-	ret.append(",");
-	ret.append(removed);
-	ret.append(",");
-	ret.append(added + changed + removed);
-	ret.append("\n");
-	return ret;
+	for (uint32 i = 0; i < Settings::DIMENSION_COUNT; i++)
+	{
+		if (valueIds[i] != other.valueIds[i])
+		{
+			return (valueIds[i] < other.valueIds[i]);
+		}
+	}
+
+	return false;
 }
 
-String DataStore::getEmptyRow(Date date)
+DataStore::Shard& DataStore::getShard()
 {
-	String formattedDate = getIsoDate(date);
+	Shard* shard = (Shard*)m_threadShard.get();
 
-	String ret;
-	ret.append(formattedDate);
-	ret.append(",0,0,0,0\n");
+	if (shard == NULL)
+	{
+		// The first count from this thread
+		shard = new Shard();
+		shard->firstBucket = 0;
+
+		Locker locker(m_mutex);
+		m_shards.push_back(shard);
+		m_threadShard.set(shard);
+	}
+
+	return *shard;
+}
+
+void DataStore::addToShard(Shard& shard, int32 bucket, uint32 linesAdded, uint32 linesChanged, uint32 linesRemoved)
+{
+	uint32 size = shard.linesAdded.size();
+
+	if (size == 0)
+	{
+		shard.firstBucket = bucket;
+	}
+
+	// Grow the run to take in the bucket at whichever end it's on
+	if (bucket < shard.firstBucket)
+	{
+		uint32 count = shard.firstBucket - bucket;
+		shard.linesAdded.insert(shard.linesAdded.begin(), count, 0);
+		shard.linesChanged.insert(shard.linesChanged.begin(), count, 0);
+		shard.linesRemoved.insert(shard.linesRemoved.begin(), count, 0);
+		shard.firstBucket = bucket;
+	}
+	else if (bucket >= shard.firstBucket + (int32)size)
+	{
+		uint32 newSize = bucket - shard.firstBucket + 1;
+		shard.linesAdded.resize(newSize, 0);
+		shard.linesChanged.resize(newSize, 0);
+		shard.linesRemoved.resize(newSize, 0);
+	}
+
+	uint32 index = bucket - shard.firstBucket;
+	shard.linesAdded[index] += linesAdded;
+	shard.linesChanged[index] += linesChanged;
+	shard.linesRemoved[index] += linesRemoved;
+}
+
+void DataStore::mergeShards()
+{
+	// Called with m_mutex held, once the threads that own the shards have
+	// stopped adding. The shards are emptied so nothing is merged twice.
+	for (uint32 i = 0; i < m_shards.size(); i++)
+	{
+		Shard& shard = *m_shards[i];
+
+		for (uint32 j = 0; j < shard.linesAdded.size(); j++)
+		{
+			DataEntry dataEntry(shard.linesAdded[j],
+				shard.linesChanged[j],
+				shard.linesRemoved[j]);
+			getEntry(shard.firstBucket + j).add(dataEntry);
+		}
+
+		if (shard.highWaterMark > m_highWaterMark)
+		{
+			m_highWaterMark = shard.highWaterMark;
+		}
+
+		shard.linesAdded.clear();
+		shard.linesChanged.clear();
+		shard.linesRemoved.clear();
+	}
+}
+
+void DataStore::addFact(Shard& shard, int32 bucket, FileDiff& fileDiff, const String& user)
+{
+	// Names that don't split up are taken as an element on no branch
+	StringView element = fileDiff.getVersion();
+	StringView branch;
+	VersionName versionName;
+
+	if (versionName.parse(element))
+	{
+		element = versionName.getElement();
+		branch = versionName.getBranch();
+	}
+
+	FactKey key;
+	key.bucket = bucket;
+
+	for (uint32 i = 0; i < Settings::DIMENSION_COUNT; i++)
+	{
+		key.valueIds[i] = 0;
+	}
+
+	const vector<Settings::dimension>& groupBy = m_settings->getGroupBy();
+
+	for (uint32 i = 0; i < groupBy.size(); i++)
+	{
+		StringView value;
+
+		switch (groupBy[i])
+		{
+			case Settings::USER:
+				value = user;
+				break;
+			case Settings::BRTYPE:
+				value = getBranchType(branch);
+				break;
+			case Settings::EXTENSION:
+				value = getExtension(element);
+				break;
+			default:
+				value = getTopDirectory(element);
+				break;
+		}
+
+		key.valueIds[groupBy[i]] = getValueId(shard, value);
+	}
+
+	DataEntry dataEntry(fileDiff);
+	shard.facts[key].add(dataEntry);
+}
+
+uint32 DataStore::getValueId(Shard& shard, const StringView& value)
+{
+	// Keep the table no more than half full so probe runs stay short
+	if ((shard.values.size() + 1) * 2 > shard.valueSlots.size())
+	{
+		growValueSlots(shard);
+	}
+
+	uint32 mask = shard.valueSlots.size() - 1;
+	uint32 slot = hashValue(value) & mask;
+
+	while (shard.valueSlots[slot] != 0)
+	{
+		uint32 id = shard.valueSlots[slot] - 1;
+
+		if (value.equals(shard.values[id]))
+		{
+			return id;
+		}
+
+		slot = (slot + 1) & mask;
+	}
+
+	// Only a value not seen before is copied
+	uint32 id = shard.values.size();
+	shard.values.push_back(value.toString());
+	shard.valueSlots[slot] = id + 1;
+	return id;
+}
+
+void DataStore::growValueSlots(Shard& shard)
+{
+	// The size stays a power of two so a hash is reduced with a mask
+	uint32 size = shard.valueSlots.size() * 2;
+
+	if (size < 16)
+	{
+		size = 16;
+	}
+
+	shard.valueSlots.assign(size, 0);
+	uint32 mask = size - 1;
+
+	for (uint32 id = 0; id < shard.values.size(); id++)
+	{
+		uint32 slot = hashValue(shard.values[id]) & mask;
+
+		while (shard.valueSlots[slot] != 0)
+		{
+			slot = (slot + 1) & mask;
+		}
+
+		shard.valueSlots[slot] = id + 1;
+	}
+}
+
+uint32 DataStore::hashValue(const StringView& value)
+{
+	// 32 bit FNV-1a
+	uint32 hash = 2166136261u;
+
+	for (uint32 i = 0; i < value.length(); i++)
+	{
+		hash ^= (uint8)value.charAt(i);
+		hash *= 16777619u;
+	}
+
+	return hash;
+}
+
+StringView DataStore::getTopDirectory(const StringView& element)
+{
+	// Take the path below the pname the element was found under, or the
+	// whole path if it doesn't start with any of them
+	const vector<String>& paths = m_settings->getPaths();
+	StringView rest = element;
+
+	for (uint32 i = 0; i < paths.size(); i++)
+	{
+		StringView path = paths[i];
+
+		while (path.length() > 0 &&
+			   (path.charAt(path.length() - 1) == '/' ||
+				path.charAt(path.length() - 1) == '\\'))
+		{
+			path = path.subView(0, path.length() - 1);
+		}
+
+		if (element.length() > path.length() &&
+			element.startsWith(path) &&
+			(element.charAt(path.length()) == '/' ||
+			 element.charAt(path.length()) == '\\'))
+		{
+			rest = element.subView(path.length() + 1, element.length());
+			break;
+		}
+	}
+
+	while (rest.length() > 0 && (rest.charAt(0) == '/' || rest.charAt(0) == '\\'))
+	{
+		rest = rest.subView(1, rest.length());
+	}
+
+	// Elements right in the pname are grouped as "."
+	int32 slashIndex = rest.indexOf('/');
+	int32 backslashIndex = rest.indexOf('\\');
+
+	if (slashIndex < 0 && backslashIndex < 0)
+	{
+		return StringView(".");
+	}
+
+	if (slashIndex < 0 || (backslashIndex >= 0 && backslashIndex < slashIndex))
+	{
+		slashIndex = backslashIndex;
+	}
+
+	return rest.subView(0, slashIndex);
+}
+
+StringView DataStore::getBranchType(const StringView& branch)
+{
+	// The last branch in the path, as in /main/br
+	int32 slashIndex = branch.lastIndexOf('/');
+	int32 backslashIndex = branch.lastIndexOf('\\');
+	int32 start = ((slashIndex > backslashIndex) ? slashIndex : backslashIndex) + 1;
+	return branch.subView(start, branch.length());
+}
+
+StringView DataStore::getExtension(const StringView& element)
+{
+	// From the last '.' of the file name, like the -exts values
+	int32 slashIndex = element.lastIndexOf('/');
+	int32 backslashIndex = element.lastIndexOf('\\');
+	int32 fileNameStart = ((slashIndex > backslashIndex) ? slashIndex : backslashIndex) + 1;
+	StringView fileName = element.subView(fileNameStart, element.length());
+	int32 dotIndex = fileName.lastIndexOf('.');
+
+	if (dotIndex < 0)
+	{
+		return StringView();
+	}
+
+	return fileName.subView(dotIndex, fileName.length());
+}
+
+String DataStore::quoteCsvField(const String& field)
+{
+	int32 commaIndex = field.indexOf(',');
+	int32 quoteIndex = field.indexOf('"');
+
+	if (commaIndex < 0 && quoteIndex < 0)
+	{
+		return field;
+	}
+
+	// Quote the field and double any quotes in it
+	String ret("\"");
+
+	for (uint32 i = 0; i < field.length(); i++)
+	{
+		char c = field.charAt(i);
+		ret.append(c);
+
+		if (c == '"')
+		{
+			ret.append(c);
+		}
+	}
+
+	ret.append('"');
 	return ret;
 }
 
-Date DataStore::roundDownDate(Date date)
+int32 DataStore::getBucket(Date date, UtcOffsetTable& utcOffsets)
+{
+	time_t unixTime = date.getTime_t();
+	return getBucket(CivilDate::fromTime_t(unixTime,
+		utcOffsets.getOffset(unixTime)));
+}
+
+int32 DataStore::getBucket(const CivilDate& day)
 {
 	Settings::timePeriod period = m_settings->getPeriod();
 
 	switch (period)
 	{
 		case Settings::MONTHLY:
-			date.roundToMonth();
+			return day.getYear() * 12 + (int32)day.getMonth();
 		case Settings::WEEKLY:
-			date.roundToWeek();
-		case Settings::DAILY:
-			date.roundToDay();
-		//default:
-			//Logging::traceln(String("DataStore::roundDownDate") +
-			//	" unexpected period setting " + (int32)period);
+			// 1970-01-01 was a Thursday, so weeks are counted from the
+			// Sunday before it
+			return divideRoundingDown(day.getDayNumber() + Date::THURSDAY, 7);
+		default:
+			return day.getDayNumber();
 	}
-
-	return date;
 }
 
-Date DataStore::incrementDate(Date date)
+CivilDate DataStore::getBucketStart(int32 bucket)
 {
 	Settings::timePeriod period = m_settings->getPeriod();
 
 	switch (period)
 	{
 		case Settings::MONTHLY:
-			date.addMonths(1);
+		{
+			int32 year = divideRoundingDown(bucket, 12);
+			return CivilDate(year, (uint32)(bucket - year * 12), 1);
+		}
 		case Settings::WEEKLY:
-			date.addWeeks(1);
-		case Settings::DAILY:
-			date.addDays(1);
-		//default:
-		//	Logging::traceln(String("DataStore::incrementDate") +
-		//		" unexpected period setting " + (int32)period);
+			return CivilDate::fromDayNumber(bucket * 7 - Date::THURSDAY);
+		default:
+			return CivilDate::fromDayNumber(bucket);
 	}
-
-	return date;
 }
 
-vector<Date> DataStore::getMissingDates(Date start, Date end)
+DataEntry& DataStore::getEntry(int32 bucket)
 {
-	vector<Date> ret;
+	if (m_buckets.empty())
+	{
+		m_firstBucket = bucket;
+	}
 
-	Date temp = incrementDate(start);
+	// Fill in empty buckets up to the new one at whichever end it's on
+	while (bucket < m_firstBucket)
+	{
+		m_buckets.push_front(DataEntry());
+		m_firstBucket--;
+	}
 
-	while (temp < end)
+	while (bucket >= m_firstBucket + (int32)m_buckets.size())
 	{
-		ret.push_back(temp);
-		temp = incrementDate(temp);
+		m_buckets.push_back(DataEntry());
 	}
 
-	return ret;
+	return m_buckets[bucket - m_firstBucket];
 }
 
-String DataStore::getIsoDate(Date date)
+String DataStore::getRow(const CivilDate& day, DataEntry& dataEntry)
 {
-	uint32 year = date.getYear();
-	uint32 month = date.getMonth()+1;
-	uint32 dayOfMonth = date.getDayOfMonth();
+	return day.toIsoString() + getCounts(dataEntry);
+}
 
-	String ret;
-	ret.append(year);
-	ret.append('-');
-	if (month < 10)
-		ret.append('0');
-	ret.append(month);
-	ret.append('-');
-	if (dayOfMonth < 10)
-		ret.append('0');
-	ret.append(dayOfMonth);
+String DataStore::getCounts(DataEntry& dataEntry)
+{
+	uint32 added = dataEntry.getLinesAdded();
+	uint32 changed = dataEntry.getLinesChanged();
+	uint32 removed = dataEntry.getLinesRemoved();
+
+	String ret(",");
+	ret.append(added);
+	ret.append(",");
+	ret.append(changed);
+	ret.append(",");
+	ret.append(removed);
+	ret.append(",");
+	ret.append(added + changed + removed);
+	ret.append("\n");
 	return ret;
 }
+
+String DataStore::getPeriodName(Settings::timePeriod period)
+{
+	switch (period)
+	{
+		case Settings::MONTHLY:
+			return "monthly";
+		case Settings::DAILY:
+			return "daily";
+		default:
+			return "weekly";
+	}
+}
+
+bool DataStore::parseBucket(const String& line, CivilDate& day, DataEntry& dataEntry)
+{
+	// 2011-11-27<TAB>6<TAB>2<TAB>0
+	String fields[4];
+	uint32 fieldStart = 0;
+
+	for (uint32 i = 0; i < 4; i++)
+	{
+		int32 fieldEnd = line.indexOf('\t', fieldStart);
+
+		// The last field runs to the end of the line
+		if (i == 3)
+		{
+			fieldEnd = line.length();
+		}
+		else if (fieldEnd < 0)
+		{
+			return false;
+		}
+
+		fields[i] = line.subString(fieldStart, fieldEnd);
+		fieldStart = fieldEnd + 1;
+	}
+
+	if (fields[0].length() != 10)
+		return false;
+
+	bool yearIsInt = true;
+	bool monthIsInt = true;
+	bool dayIsInt = true;
+	uint32 year = fields[0].subString(0, 4).toUInt32(yearIsInt);
+	uint32 month = fields[0].subString(5, 7).toUInt32(monthIsInt);
+	uint32 dayOfMonth = fields[0].subString(8, 10).toUInt32(dayIsInt);
+
+	if (!yearIsInt || !monthIsInt || !dayIsInt || month < 1 || month > 12 ||
+		dayOfMonth < 1 || dayOfMonth > 31)
+		return false;
+
+	bool addedIsInt = true;
+	bool changedIsInt = true;
+	bool removedIsInt = true;
+	uint32 added = fields[1].toUInt32(addedIsInt);
+	uint32 changed = fields[2].toUInt32(changedIsInt);
+	uint32 removed = fields[3].toUInt32(removedIsInt);
+
+	if (!addedIsInt || !changedIsInt || !removedIsInt)
+		return false;
+
+	day = CivilDate(year, month - 1, dayOfMonth);
+	dataEntry = DataEntry(added, changed, removed);
+	return true;
+}
+
+int32 DataStore::divideRoundingDown(int32 dividend, int32 divisor)
+{
+	int32 quotient = dividend / divisor;
+
+	if (dividend % divisor < 0)
+		quotient--;
+
+	return quotient;
+}
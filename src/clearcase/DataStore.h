@@ -5,36 +5,168 @@
 
 #include <Settings.h>
 #include <clearcase/DataEntry.h>
+#include <clearcase/FileDiff.h>
+#include <io/InputStream.h>
 #include <io/OutputStream.h>
+#include <text/String.h>
+#include <text/StringView.h>
 #include <thread/Mutex.h>
-#include <util/Locker.h>
+#include <thread/ThreadLocal.h>
+#include <util/CivilDate.h>
 #include <util/Date.h>
+#include <util/Locker.h>
+#include <util/UtcOffsetTable.h>
 
+#include <deque>
 #include <map>
 #include <vector>
 using namespace std;
 
+/*
+ * Sums up the line counts of versions into one bucket per day, week or
+ * month.
+ *
+ * Buckets are numbered with integer arithmetic: days since 1970-01-01,
+ * weeks (starting on Sunday) since then, or months since year zero. They
+ * are kept in one run from the earliest bucket with data to the latest,
+ * so the empty buckets in between are already in place for the output.
+ *
+ * For -incremental the buckets can be saved together with a high-water
+ * mark, the creation time of the newest version diffed, and restored by
+ * the next run. Versions created at or before the restored mark are then
+ * refused by claimVersion() so they aren't counted twice.
+ *
+ * With -groupby each version is also kept as a fact keyed by its bucket,
+ * user, branch type, extension and top-level directory, so every group-by
+ * report comes from the one run. Only the dimensions asked for are filled
+ * in, each as a small ID for its value, so versions that share them share
+ * one fact. The IDs are looked up in a hash table by view, so a value is
+ * only copied the first time it is seen. Facts aren't saved with the
+ * incremental state.
+ *
+ * addData() and claimVersion() don't take a lock. Each thread counts into
+ * a shard of its own, a dense run of buckets with the added, changed and
+ * removed counts in separate arrays, and the shards are merged when the
+ * results are written. The store's lock is only taken to register a
+ * thread's shard on its first count. A pool worker that replaces one that
+ * went idle gets a new shard, and the old one waits to be merged.
+ *
+ * Safe for access by multiple threads, except that the write functions
+ * must not be called while other threads are still adding.
+ */
 class DataStore
 {
 public:
 	DataStore(Settings* settings);
 	~DataStore();
 
-	void addData(Date date, FileDiff& fileDiff);
+	/*
+	 * Adds the counts of a version created by user. The other group-by
+	 * dimensions are worked out from the version name.
+	 */
+	void addData(Date date, FileDiff& fileDiff, const String& user);
 	void addData(Date date, DataEntry& dataEntry);
 	void writeToStream(OutputStream& outputStream);
 
+	/*
+	 * Writes the -groupby report for one dimension: a row for each value
+	 * with counts in each period, sorted by period then value.
+	 */
+	void writeGroupToStream(Settings::dimension dimension, OutputStream& outputStream);
+
+	/*
+	 * Called with the creation time of a version, in the form
+	 * 2011-12-02T07:45:28, before its counts are added. Any UTC offset
+	 * after the time is ignored, as the mark is local time like the -since
+	 * date cleartool takes. Returns false if
+	 * the restored state already includes the version, otherwise moves the
+	 * high-water mark up to it and returns true.
+	 */
+	bool claimVersion(const String& createdAt);
+
+	/*
+	 * Returns the calling thread's table of UTC offsets, for turning the
+	 * local creation times of versions into Dates before they are added.
+	 * No lock is taken.
+	 */
+	UtcOffsetTable& getUtcOffsets();
+
+	/*
+	 * Returns the restored high-water mark in a form cleartool accepts
+	 * for created_since() and -since, or an empty string if there is none.
+	 */
+	String getSinceDate();
+
+	/*
+	 * Restores the buckets and high-water mark saved by writeState().
+	 * Throws ParsingException if the state is damaged or was saved for a
+	 * different period.
+	 */
+	void readState(InputStream& inputStream);
+	void writeState(OutputStream& outputStream);
+
 private:
-	static String getRow(Date date, DataEntry& dataEntry);
-	static String getEmptyRow(Date date);
-	Date roundDownDate(Date date);
-	Date incrementDate(Date date);
-	vector<Date> getMissingDates(Date start, Date end);
-	static String getIsoDate(Date date);
+	DataStore(const DataStore& other) {}
+	DataStore& operator=(const DataStore& other) {}
+
+	/*
+	 * A group-by fact. Dimensions not asked for are left at 0.
+	 */
+	struct FactKey
+	{
+		int32 bucket;
+		uint32 valueIds[Settings::DIMENSION_COUNT]; // Into the shard's values
+
+		bool operator<(const FactKey& other) const;
+	};
+
+	/*
+	 * The counts added by one thread. Bucket i of the arrays is bucket
+	 * number firstBucket + i. Facts stay in the shard until a report is
+	 * written, as their value IDs only mean something within it.
+	 */
+	struct Shard
+	{
+		UtcOffsetTable utcOffsets;
+		int32 firstBucket;
+		vector<uint32> linesAdded;
+		vector<uint32> linesChanged;
+		vector<uint32> linesRemoved;
+		String highWaterMark;
+		map<FactKey, DataEntry> facts;
+		vector<String> values; // Indexed by value ID
+		vector<uint32> valueSlots; // Hash table of value ID + 1, 0 if empty
+	};
+
+	Shard& getShard();
+	void addToShard(Shard& shard, int32 bucket, uint32 linesAdded, uint32 linesChanged, uint32 linesRemoved);
+	void addFact(Shard& shard, int32 bucket, FileDiff& fileDiff, const String& user);
+	uint32 getValueId(Shard& shard, const StringView& value);
+	static void growValueSlots(Shard& shard);
+	static uint32 hashValue(const StringView& value);
+	StringView getTopDirectory(const StringView& element);
+	static StringView getBranchType(const StringView& branch);
+	static StringView getExtension(const StringView& element);
+	static String quoteCsvField(const String& field);
+	void mergeShards();
+	int32 getBucket(Date date, UtcOffsetTable& utcOffsets);
+	int32 getBucket(const CivilDate& day);
+	CivilDate getBucketStart(int32 bucket);
+	DataEntry& getEntry(int32 bucket);
+	static String getRow(const CivilDate& day, DataEntry& dataEntry);
+	static String getCounts(DataEntry& dataEntry);
+	static String getPeriodName(Settings::timePeriod period);
+	static bool parseBucket(const String& line, CivilDate& day, DataEntry& dataEntry);
+	static int32 divideRoundingDown(int32 dividend, int32 divisor);
 
 	Settings* m_settings;
 	Mutex m_mutex;
-	map<Date, DataEntry> m_dataMap;
+	ThreadLocal m_threadShard; // The calling thread's Shard
+	vector<Shard*> m_shards; // One per thread that has counted anything
+	deque<DataEntry> m_buckets; // The first is bucket number m_firstBucket
+	int32 m_firstBucket;
+	String m_restoredMark; // Empty if no state was restored
+	String m_highWaterMark; // Only up to date once the shards are merged
 };
 
 #endif // DATA_STORE_H
@@ -3,6 +3,14 @@
 #include "Description.h"
 #include <exception/ParsingException.h>
 
+#include <string.h> // For strlen()
+
+// Starts the line naming the predecessor, missing for zero versions
+#define PREDECESSOR_TEXT "predecessor version: "
+
+// The number of tab delimited fields in a DESCRIPTION_FORMAT record
+#define RECORD_FIELD_COUNT 6
+
 // Example file description
 /*
 version "/vobs/sw/happy_xml.xml@@/main/xml_update/3"
@@ -30,6 +38,11 @@ symbolic link ".\AdventNet_Turin\download\custom\ciena\download" -> .
     Other:          : rwx
 */
 
+// Example DESCRIPTION_FORMAT record (tabs shown as <TAB>)
+/*
+/vobs/sw/happy_xml.xml@@/main/xml_update/3<TAB>20060908.165714<TAB>zoolander<TAB>version<TAB>/main/xml_update/2<TAB>"Merge@1@/vobs/sw" <- "/vobs/sw/happy_xml.xml@@/main/292"
+*/
+
 
 Description::Description()
 {
@@ -44,20 +57,26 @@ Description::~Description()
 
 }
 
-void Description::populate(String versionName, String desc)
+void Description::populate(const String& versionName, const String& descText)
 {
 	m_isInvalid = true;
 
 	// Skip warning on systems that have configuration issues
 	// Can start with a string like:
 	// noname: Warning: Can not find a group named "xxx\yyy"
-	if (desc.startsWith("noname:"))
+	// Only then is the text copied.
+	bool hasWarning = descText.startsWith("noname:");
+	String withoutWarning;
+
+	if (hasWarning)
 	{
-		desc = desc.subString(desc.indexOf('\n') + 1);
+		withoutWarning = descText.subString(descText.indexOf('\n') + 1);
 	}
 
-	// Store the version name
-	m_versionName.assign(versionName);
+	const String& desc = hasWarning ? withoutWarning : descText;
+
+	// Point at the version name
+	m_versionName = StringView(versionName);
 
 	// First words incicate the file type
 	m_isDirectory = desc.startsWith("directory");
@@ -89,8 +108,9 @@ void Description::populate(String versionName, String desc)
 	// Extract the date
 	m_createDate.assign(desc.subString(dateStart, dateEnd));
 
-	// The time is after the date, it ends with either a space or a timezone offset (-7:00)
-	int timeEnd = desc.indexOf('-', dateEnd-1);
+	// The time is after the date and ends with a space. Any timezone offset
+	// (-07 or -07:00) is kept with it.
+	int timeEnd = desc.indexOf(' ', dateEnd);
 	if (timeEnd < 0)
 	{
 		throw ParsingException(String("Failed to parse \"created \" date for: ") + versionName);
@@ -149,5 +169,98 @@ void Description::populate(String versionName, String desc)
 	// If we found the index then the version was merged to
 	m_mergeTo = (mergeToStart > 0);
 
+	// The predecessor follows the comment on a line of its own
+	int predecessorStart = desc.indexOf(PREDECESSOR_TEXT, commentEnd);
+
+	if (predecessorStart > 0)
+	{
+		predecessorStart += strlen(PREDECESSOR_TEXT);
+		int predecessorEnd = desc.indexOf('\n', predecessorStart);
+
+		if (predecessorEnd < 0)
+		{
+			predecessorEnd = desc.length();
+		}
+
+		m_predecessor.assign(desc.subString(predecessorStart, predecessorEnd));
+		m_predecessor.trim();
+	}
+
 	m_isInvalid = false;
 }
+
+void Description::populateFromRecord(const String& record)
+{
+	m_isInvalid = true;
+
+	// Split the record into its fields
+	String fields[RECORD_FIELD_COUNT];
+	uint32 fieldStart = 0;
+
+	for (uint32 i = 0; i < RECORD_FIELD_COUNT; i++)
+	{
+		int32 fieldEnd = record.indexOf('\t', fieldStart);
+
+		// The last field runs to the end of the record
+		if (i == RECORD_FIELD_COUNT - 1)
+		{
+			fieldEnd = record.length();
+		}
+		else if (fieldEnd < 0)
+		{
+			throw ParsingException(String("Missing fields in description "
+				"record: ") + record);
+		}
+
+		// The version name is viewed in place rather than copied
+		if (i == 0)
+		{
+			m_versionName = StringView(record.c_str(), fieldEnd);
+		}
+		else
+		{
+			fields[i] = record.subString(fieldStart, fieldEnd);
+		}
+
+		fieldStart = fieldEnd + 1;
+	}
+
+	// The numeric date has the fixed format YYYYMMDD.HHMMSS
+	String numericDate = fields[1];
+
+	if (numericDate.length() != 15 || numericDate.charAt(8) != '.')
+	{
+		throw ParsingException(String("Failed to parse date in description "
+			"record for: ") + m_versionName.toString());
+	}
+
+	m_createDate.assign(numericDate.subString(0, 4) + '-' +
+		numericDate.subString(4, 6) + '-' + numericDate.subString(6, 8));
+	m_createTime.assign(numericDate.subString(9, 11) + ':' +
+		numericDate.subString(11, 13) + ':' + numericDate.subString(13, 15));
+
+	m_user.assign(fields[2]);
+
+	// The object kind is "version", "directory version" or "symbolic link"
+	m_isDirectory = fields[3].startsWith("directory");
+	m_isSymbolicLink = fields[3].startsWith("symbolic link");
+
+	m_predecessor.assign(fields[4]);
+
+	// Merge hyperlinks pointing at this version use a left arrow
+	m_mergeTo = ((int32)fields[5].indexOf("<-") >= 0);
+
+	m_isInvalid = false;
+}
+
+StringView Description::getRecordVersionName(const String& record)
+{
+	int32 nameEnd = record.indexOf('\t');
+
+	if (nameEnd <= 0)
+	{
+		return StringView();
+	}
+
+	return StringView(record.c_str(), nameEnd);
+}
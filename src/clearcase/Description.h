@@ -4,6 +4,16 @@
 #define DESCRIPTION_H
 
 #include <text/String.h>
+#include <text/StringView.h>
+
+/*
+ * The -fmt string used wherever cleartool can describe versions for us
+ * without a separate "cleartool describe" call. Produces one tab delimited
+ * record per version:
+ *
+ * name, numeric date, user, object kind, predecessor, merge hyperlinks
+ */
+#define DESCRIPTION_FORMAT "%Xn\\t%Nd\\t%u\\t%m\\t%PVn\\t%[hlink:Merge]p\\n"
 
 /*
  * Represents the returned data from a call to "cleartool describe"
@@ -17,18 +27,37 @@ public:
 	/*
 	 * Populates with data from a call to "cleartool describe"
 	 *
+	 * m_versionName is left pointing at versionName rather than a copy.
+	 *
 	 * Throws ParsingException if there was an error parsing the result.
 	 */
-	void populate(String versionName, String desc);
+	void populate(const String& versionName, const String& descText);
+
+	/*
+	 * Populates with a single line of output produced by DESCRIPTION_FORMAT.
+	 *
+	 * m_versionName is left pointing into the record rather than a copy.
+	 *
+	 * Throws ParsingException if the record doesn't have the expected fields.
+	 */
+	void populateFromRecord(const String& record);
+
+	/*
+	 * Returns a view of the version name at the start of a
+	 * DESCRIPTION_FORMAT record, or an empty view if the line is not a
+	 * record.
+	 */
+	static StringView getRecordVersionName(const String& record);
 
 	bool m_isInvalid;
 	bool m_isDirectory;
 	bool m_isSymbolicLink;
-	String m_versionName;
+	StringView m_versionName; // Points into the text given to populate
 	String m_createDate;
 	String m_createTime;
 	String m_user;
 	String m_comment;
+	String m_predecessor;
 	bool m_mergeTo;
 };
 
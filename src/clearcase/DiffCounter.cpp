@@ -0,0 +1,379 @@
+// DiffCounter.cpp
+
+#include "DiffCounter.h"
+
+#include <ctype.h> // For isdigit()
+#include <string.h> // For memchr() and strncmp()
+#include <algorithm> // For min() and max()
+using namespace std;
+
+#ifdef HAS_SSE2
+#	include <emmintrin.h> // For SSE2 intrinsics
+#endif
+
+// The longest start of a line that needs to be kept. Longer than any line
+// of ranges with 32 bit numbers, the rest of which is ignored anyway.
+#define LINE_PREFIX_LENGTH 64
+
+// Warnings on systems that have configuration issues, like:
+// noname: Warning: Can not find a group named "xxx\yyy"
+#define WARNING_PREFIX "noname:"
+#define MAX_WARNING_LINES 2
+
+
+DiffCounter::DiffCounter()
+{
+	reset();
+}
+
+DiffCounter::~DiffCounter()
+{
+
+}
+
+void DiffCounter::close()
+{
+
+}
+
+int32 DiffCounter::write(int32 byte)
+{
+	char tempBuffer[1];
+	tempBuffer[0] = (char)(byte & 0x000000ff);
+
+	return (int32)write(tempBuffer, 1);
+}
+
+int64 DiffCounter::write(const void* buffer, uint32 maxlen)
+{
+	const char* pos = (const char*)buffer;
+	const char* end = pos + maxlen;
+
+	if (maxlen > 0)
+	{
+		m_hasOutput = true;
+	}
+
+	while (pos < end)
+	{
+		// Nearly all of a diff is the lines listing each hunk. Jump over
+		// them to the next line that needs a closer look.
+		if (m_inHunk && m_carryLength == 0 && !m_pendingEmptyLine &&
+			isHunkLine(*pos))
+		{
+			pos = skipHunkLines(pos, end);
+
+			if (pos == end)
+			{
+				break;
+			}
+		}
+
+		const char* newline = (const char*)memchr(pos, '\n', end - pos);
+		const char* lineEnd = (newline != NULL) ? newline : end;
+		uint32 length = (uint32)(lineEnd - pos);
+
+		if (newline != NULL && m_carryLength == 0)
+		{
+			// The whole line is here, so count it where it is
+			countLine(pos, length);
+		}
+		else
+		{
+			// Keep no more of the line than countLine() looks at
+			if (m_carry.length() < LINE_PREFIX_LENGTH)
+			{
+				m_carry.append(pos, min<uint32>(length,
+					LINE_PREFIX_LENGTH - m_carry.length()));
+			}
+
+			m_carryLength += length;
+
+			if (newline != NULL)
+			{
+				countLine(m_carry.c_str(), m_carryLength);
+				m_carry = String();
+				m_carryLength = 0;
+			}
+		}
+
+		if (newline == NULL)
+		{
+			break;
+		}
+
+		pos = newline + 1;
+	}
+
+	return maxlen;
+}
+
+bool DiffCounter::finish(String& error)
+{
+	// A last character on its own isn't a line worth reading, unless an
+	// empty line came before it
+	if (m_carryLength > 1 || (m_carryLength == 1 && m_pendingEmptyLine))
+	{
+		countLine(m_carry.c_str(), m_carryLength);
+	}
+
+	m_carry = String();
+	m_carryLength = 0;
+
+	error = m_error;
+	return (m_error.length() == 0);
+}
+
+void DiffCounter::reset()
+{
+	m_carry = String();
+	m_carryLength = 0;
+	m_hasOutput = false;
+	m_inPreamble = true;
+	m_preambleLines = 0;
+	m_inHunk = false;
+	m_pendingEmptyLine = false;
+	m_linesAdded = 0;
+	m_linesChanged = 0;
+	m_linesRemoved = 0;
+	m_error = String();
+}
+
+bool DiffCounter::isEmpty()
+{
+	return !m_hasOutput;
+}
+
+uint32 DiffCounter::getLinesAdded()
+{
+	return m_linesAdded;
+}
+
+uint32 DiffCounter::getLinesChanged()
+{
+	return m_linesChanged;
+}
+
+uint32 DiffCounter::getLinesRemoved()
+{
+	return m_linesRemoved;
+}
+
+// Private functions --------------------------------------------------------
+
+void DiffCounter::countLine(const char* line, uint32 length)
+{
+	// Only the first problem is reported
+	if (m_error.length() > 0)
+	{
+		return;
+	}
+
+	// Only the start of the line may be at hand
+	uint32 available = min<uint32>(length, LINE_PREFIX_LENGTH);
+
+	// Skip warnings before the diff
+	if (m_inPreamble && m_preambleLines < MAX_WARNING_LINES &&
+		available >= strlen(WARNING_PREFIX) &&
+		strncmp(line, WARNING_PREFIX, strlen(WARNING_PREFIX)) == 0)
+	{
+		m_preambleLines++;
+		return;
+	}
+
+	m_inPreamble = false;
+
+	// An empty line is only allowed at the very end
+	if (m_pendingEmptyLine)
+	{
+		m_error = "couldn't read left hand version range";
+		return;
+	}
+
+	if (length == 0)
+	{
+		m_pendingEmptyLine = true;
+		return;
+	}
+
+	// Skip the "<", ">" and "---" lines listing a hunk
+	if (m_inHunk && isHunkLine(line[0]))
+	{
+		return;
+	}
+
+	countRanges(line, available);
+}
+
+void DiffCounter::countRanges(const char* line, uint32 length)
+{
+	const char* pos = line;
+	const char* end = line + length;
+
+	// Read the range of lines changed in the prev copy
+	DiffRange prevRange;
+
+	if (!readRange(pos, end, prevRange))
+	{
+		m_error = "couldn't read left hand version range";
+		return;
+	}
+
+	if (pos == end)
+	{
+		m_error = "unexpected end of text";
+		return;
+	}
+
+	char typeChar = *pos;
+	pos++;
+
+	// Read the range of lines changed in the current copy
+	DiffRange curRange;
+
+	if (!readRange(pos, end, curRange))
+	{
+		m_error = "count'r read right hand version range";
+		return;
+	}
+
+	// Get the number of lines changed
+	uint32 prevCount = prevRange.max - prevRange.min +1;
+	uint32 curCount = curRange.max - curRange.min +1;
+
+	// Increment counters based on the diff type character
+	switch (typeChar)
+	{
+		case 'a':
+			m_linesAdded += curCount;
+			break;
+		case 'c':
+			// We take the larger of the old and new as lengthening
+			// or shortening code is both "change"
+			m_linesChanged += max<uint32>(prevCount, curCount);
+			break;
+		case 'd':
+			m_linesRemoved += prevCount;
+			break;
+		default:
+			m_error = String("unexpected character: \'") + typeChar + "\'";
+			return;
+	}
+
+	// The rest of the line is ignored
+	m_inHunk = true;
+}
+
+bool DiffCounter::isHunkLine(char firstChar)
+{
+	return (firstChar == '<' || firstChar == '>' || firstChar == '-');
+}
+
+const char* DiffCounter::skipHunkLines(const char* pos, const char* end)
+{
+	const char* scan = pos;
+
+#ifdef HAS_SSE2
+	const __m128i newline = _mm_set1_epi8('\n');
+	const __m128i lessThan = _mm_set1_epi8('<');
+	const __m128i greaterThan = _mm_set1_epi8('>');
+	const __m128i dash = _mm_set1_epi8('-');
+
+	// Test 16 bytes at a time for a newline followed by something other
+	// than a hunk line. The byte after each newline comes from a second
+	// load one byte further on, so stop while 17 bytes remain.
+	while (end - scan > 16)
+	{
+		__m128i bytes = _mm_loadu_si128((const __m128i*)scan);
+		__m128i nextBytes = _mm_loadu_si128((const __m128i*)(scan + 1));
+
+		__m128i isNewline = _mm_cmpeq_epi8(bytes, newline);
+		__m128i startsHunkLine = _mm_or_si128(
+			_mm_or_si128(_mm_cmpeq_epi8(nextBytes, lessThan),
+						 _mm_cmpeq_epi8(nextBytes, greaterThan)),
+			_mm_cmpeq_epi8(nextBytes, dash));
+
+		uint32 mask = (uint32)_mm_movemask_epi8(
+			_mm_andnot_si128(startsHunkLine, isNewline));
+
+		if (mask != 0)
+		{
+			// The lowest set bit is the first such newline
+			uint32 offset = 0;
+
+			while ((mask & 1) == 0)
+			{
+				mask >>= 1;
+				offset++;
+			}
+
+			return scan + offset + 1;
+		}
+
+		scan += 16;
+	}
+#endif
+
+	// One byte at a time for whatever is left
+	while (scan < end)
+	{
+		if (*scan == '\n' && (scan + 1 == end || !isHunkLine(scan[1])))
+		{
+			return scan + 1;
+		}
+
+		scan++;
+	}
+
+	// Only hunk lines, the last of which continues in the next write.
+	// Back up to its start so it is kept like any other split line.
+	while (scan > pos && scan[-1] != '\n')
+	{
+		scan--;
+	}
+
+	return scan;
+}
+
+bool DiffCounter::readRange(const char*& pos, const char* end, DiffRange& range)
+{
+	// Extract the first number
+	if (!readNumber(pos, end, range.min))
+	{
+		return false;
+	}
+
+	// If it is followed by a comma then the next number is the end of the range
+	if (pos < end && *pos == ',')
+	{
+		pos++;
+		return readNumber(pos, end, range.max);
+	}
+
+	// There was no comma so it is a single line change
+	range.max = range.min;
+	return true;
+}
+
+bool DiffCounter::readNumber(const char*& pos, const char* end, uint32& number)
+{
+	const char* start = pos;
+	number = 0;
+
+	// Extract the number incrementing as we go
+	while (pos < end && isdigit(*pos))
+	{
+		uint32 digit = *pos - '0';
+
+		// Don't let the number wrap around
+		if (number > (0xFFFFFFFF - digit) / 10)
+		{
+			return false;
+		}
+
+		number = number * 10 + digit;
+		pos++;
+	}
+
+	return (pos != start);
+}
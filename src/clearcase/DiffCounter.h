@@ -0,0 +1,86 @@
+// DiffCounter.h
+
+#ifndef DIFF_COUNTER_H
+#define DIFF_COUNTER_H
+
+#include <ccsponge.h>
+#include <io/OutputStream.h>
+#include <text/String.h>
+
+/*
+ * Counts the lines added, changed and removed in the output of
+ * "cleartool diff -diff_format" as it is written, a piece at a time.
+ *
+ * Only the totals and the start of a line split between two writes are
+ * kept, so the memory used is the same however big the diff is. The lines
+ * listing the hunks are skipped by their first character alone, searching
+ * 16 bytes at a time with SSE2 where it's available.
+ *
+ * Nothing is thrown while writing, since the writer is usually in the
+ * middle of reading cleartool's output. The first problem found is kept
+ * and reported by finish().
+ *
+ * Not safe for access by multiple threads.
+ */
+class DiffCounter : public OutputStream
+{
+public:
+	DiffCounter();
+	~DiffCounter();
+
+	void close();
+	int32 write(int32 byte);
+	int64 write(const void* buffer, uint32 maxlen);
+
+	/*
+	 * Counts the last line if it wasn't ended by a newline. Returns false
+	 * and sets error if the text didn't match the diff format.
+	 */
+	bool finish(String& error);
+
+	/*
+	 * Throws away everything written so far.
+	 */
+	void reset();
+
+	/*
+	 * Returns true if nothing at all was written.
+	 */
+	bool isEmpty();
+
+	uint32 getLinesAdded();
+	uint32 getLinesChanged();
+	uint32 getLinesRemoved();
+
+private:
+	DiffCounter(const DiffCounter& other) {}
+	DiffCounter& operator=(const DiffCounter& other) {}
+
+	struct DiffRange
+	{
+		uint32 min;
+		uint32 max;
+	};
+
+	void countLine(const char* line, uint32 length);
+	void countRanges(const char* line, uint32 length);
+	static bool isHunkLine(char firstChar);
+	static const char* skipHunkLines(const char* pos, const char* end);
+	static bool readRange(const char*& pos, const char* end, DiffRange& range);
+	static bool readNumber(const char*& pos, const char* end, uint32& number);
+
+	String m_carry; // Start of a line continued in the next write
+	uint32 m_carryLength; // Full length of that line so far
+	bool m_hasOutput;
+	bool m_inPreamble; // Still on the warning lines before the diff
+	uint32 m_preambleLines;
+	bool m_inHunk;
+	bool m_pendingEmptyLine;
+	String m_error;
+
+	uint32 m_linesAdded;
+	uint32 m_linesChanged;
+	uint32 m_linesRemoved;
+};
+
+#endif // DIFF_COUNTER_H
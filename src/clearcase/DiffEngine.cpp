@@ -0,0 +1,581 @@
+// DiffEngine.cpp
+
+#include "DiffEngine.h"
+
+#include <map>
+#include <string.h> // For memcmp() and memchr()
+using namespace std;
+
+// The fewest edits at which findMiddle() stops looking for the best split
+#define MIN_TOO_EXPENSIVE 4096
+
+// Marks diagonals the backward search hasn't reached, above any x
+#define UNREACHED 0x7FFFFFFF
+
+DiffEngine::DiffEngine()
+{
+	m_linesAdded = 0;
+	m_linesChanged = 0;
+	m_linesRemoved = 0;
+}
+
+DiffEngine::~DiffEngine()
+{
+
+}
+
+void DiffEngine::compare(const String& prevText, const String& curText)
+{
+	m_linesAdded = 0;
+	m_linesChanged = 0;
+	m_linesRemoved = 0;
+
+	vector<LineKey> prevLines;
+	vector<LineKey> curLines;
+	splitLines(prevText, prevLines);
+	splitLines(curText, curLines);
+
+	// Compare numbers rather than text from here on
+	uint32 idCount = assignIds(prevLines, curLines);
+	discardUnmatched(idCount);
+
+	// Past this many edits the search settles for a good split rather than
+	// the best one, roughly the square root of the number of lines
+	m_tooExpensive = 1;
+
+	for (uint32 diagonals = (uint32)(m_prev.size() + m_cur.size() + 3);
+		 diagonals != 0;
+		 diagonals >>= 2)
+	{
+		m_tooExpensive <<= 1;
+	}
+
+	m_tooExpensive = max<int32>(MIN_TOO_EXPENSIVE, m_tooExpensive);
+
+	compareRange(0, (uint32)m_prev.size(), 0, (uint32)m_cur.size());
+	shiftBoundaries(m_prevLines, m_removed, m_inserted);
+	shiftBoundaries(m_curLines, m_inserted, m_removed);
+	countHunks();
+}
+
+uint32 DiffEngine::getLinesAdded()
+{
+	return m_linesAdded;
+}
+
+uint32 DiffEngine::getLinesChanged()
+{
+	return m_linesChanged;
+}
+
+uint32 DiffEngine::getLinesRemoved()
+{
+	return m_linesRemoved;
+}
+
+bool DiffEngine::LineKey::operator<(const LineKey& other) const
+{
+	if (length != other.length)
+	{
+		return length < other.length;
+	}
+
+	return memcmp(data, other.data, length) < 0;
+}
+
+// Private functions --------------------------------------------------------
+
+void DiffEngine::splitLines(const String& text, vector<LineKey>& lines)
+{
+	const char* data = text.c_str();
+	const char* end = data + text.length();
+
+	while (data < end)
+	{
+		const char* newline = (const char*)memchr(data, '\n', end - data);
+
+		// The line keeps its newline, the last one may not have one
+		const char* lineEnd = (newline != NULL) ? newline + 1 : end;
+
+		LineKey line;
+		line.data = data;
+		line.length = (uint32)(lineEnd - data);
+		lines.push_back(line);
+
+		data = lineEnd;
+	}
+}
+
+uint32 DiffEngine::assignIds(vector<LineKey>& prevLines, vector<LineKey>& curLines)
+{
+	map<LineKey, uint32> ids;
+
+	m_prevLines.resize(prevLines.size());
+	m_curLines.resize(curLines.size());
+
+	for (uint32 i = 0; i < prevLines.size(); i++)
+	{
+		m_prevLines[i] = ids.insert(make_pair(prevLines[i], (uint32)ids.size())).first->second;
+	}
+
+	for (uint32 i = 0; i < curLines.size(); i++)
+	{
+		m_curLines[i] = ids.insert(make_pair(curLines[i], (uint32)ids.size())).first->second;
+	}
+
+	return (uint32)ids.size();
+}
+
+void DiffEngine::discardUnmatched(uint32 idCount)
+{
+	vector<bool> inPrev(idCount, false);
+	vector<bool> inCur(idCount, false);
+
+	for (uint32 i = 0; i < m_prevLines.size(); i++)
+	{
+		inPrev[m_prevLines[i]] = true;
+	}
+
+	for (uint32 i = 0; i < m_curLines.size(); i++)
+	{
+		inCur[m_curLines[i]] = true;
+	}
+
+	m_removed.assign(m_prevLines.size(), false);
+	m_inserted.assign(m_curLines.size(), false);
+	m_prev.clear();
+	m_cur.clear();
+	m_prevLineNumbers.clear();
+	m_curLineNumbers.clear();
+
+	// A line missing from the other side can't be matched, so it is a
+	// difference already and is left out of the search. Without them a
+	// rewritten file costs next to nothing to compare.
+	for (uint32 i = 0; i < m_prevLines.size(); i++)
+	{
+		if (inCur[m_prevLines[i]])
+		{
+			m_prev.push_back(m_prevLines[i]);
+			m_prevLineNumbers.push_back(i);
+		}
+		else
+		{
+			m_removed[i] = true;
+		}
+	}
+
+	for (uint32 i = 0; i < m_curLines.size(); i++)
+	{
+		if (inPrev[m_curLines[i]])
+		{
+			m_cur.push_back(m_curLines[i]);
+			m_curLineNumbers.push_back(i);
+		}
+		else
+		{
+			m_inserted[i] = true;
+		}
+	}
+}
+
+void DiffEngine::compareRange(uint32 prevStart, uint32 prevEnd,
+							  uint32 curStart, uint32 curEnd)
+{
+	// Matching lines at either end are always part of the common
+	// subsequence, and trimming them keeps the search space small
+	while (prevStart < prevEnd && curStart < curEnd &&
+		   m_prev[prevStart] == m_cur[curStart])
+	{
+		prevStart++;
+		curStart++;
+	}
+
+	while (prevStart < prevEnd && curStart < curEnd &&
+		   m_prev[prevEnd - 1] == m_cur[curEnd - 1])
+	{
+		prevEnd--;
+		curEnd--;
+	}
+
+	// With one side used up the rest of the other side is the difference
+	if (prevStart == prevEnd)
+	{
+		for (uint32 i = curStart; i < curEnd; i++)
+		{
+			m_inserted[m_curLineNumbers[i]] = true;
+		}
+
+		return;
+	}
+
+	if (curStart == curEnd)
+	{
+		for (uint32 i = prevStart; i < prevEnd; i++)
+		{
+			m_removed[m_prevLineNumbers[i]] = true;
+		}
+
+		return;
+	}
+
+	// Otherwise split around the middle of a shortest edit path and
+	// compare each half
+	uint32 prevSplit;
+	uint32 curSplit;
+	findMiddle(prevStart, prevEnd, curStart, curEnd, prevSplit, curSplit);
+
+	compareRange(prevStart, prevSplit, curStart, curSplit);
+	compareRange(prevSplit, prevEnd, curSplit, curEnd);
+}
+
+void DiffEngine::findMiddle(uint32 prevStart, uint32 prevEnd,
+							uint32 curStart, uint32 curEnd,
+							uint32& prevSplit, uint32& curSplit)
+{
+	// Same approach as diag() in GNU diff, including its cut off for very
+	// expensive comparisons.
+	// Diagonal k holds the lines where x - y = k, with x and y indexes into
+	// m_prev and m_cur. The forward search starts on the diagonal through
+	// the top left corner and the backward search on the one through the
+	// bottom right corner.
+	int32 minDiagonal = (int32)prevStart - (int32)curEnd;
+	int32 maxDiagonal = (int32)prevEnd - (int32)curStart;
+	int32 forwardMid = (int32)prevStart - (int32)curStart;
+	int32 backwardMid = (int32)prevEnd - (int32)curEnd;
+
+	// One spare diagonal either side so neighbours can always be read
+	int32 offset = 1 - minDiagonal;
+	int32 size = maxDiagonal - minDiagonal + 3;
+
+	// Furthest x reached forwards and backwards on each diagonal
+	m_forward.assign(size, -1);
+	m_backward.assign(size, UNREACHED);
+	m_forward[forwardMid + offset] = prevStart;
+	m_backward[backwardMid + offset] = prevEnd;
+
+	int32 forwardMin = forwardMid;
+	int32 forwardMax = forwardMid;
+	int32 backwardMin = backwardMid;
+	int32 backwardMax = backwardMid;
+
+	// The searches can only meet after a forward step if the two middle
+	// diagonals are an odd distance apart, otherwise after a backward step
+	bool odd = ((forwardMid - backwardMid) & 1) != 0;
+
+	// Both texts have lines and share none at either end, so there is at
+	// least one edit and the searches always meet
+	for (int32 edits = 1; ; edits++)
+	{
+		// Extend the forward search by an edit on each diagonal
+		if (forwardMin > minDiagonal)
+		{
+			m_forward[--forwardMin - 1 + offset] = -1;
+		}
+		else
+		{
+			forwardMin++;
+		}
+
+		if (forwardMax < maxDiagonal)
+		{
+			m_forward[++forwardMax + 1 + offset] = -1;
+		}
+		else
+		{
+			forwardMax--;
+		}
+
+		for (int32 k = forwardMax; k >= forwardMin; k -= 2)
+		{
+			int32 low = m_forward[k - 1 + offset];
+			int32 high = m_forward[k + 1 + offset];
+			int32 x = (low < high) ? high : low + 1;
+			int32 y = x - k;
+
+			while (x < (int32)prevEnd && y < (int32)curEnd && m_prev[x] == m_cur[y])
+			{
+				x++;
+				y++;
+			}
+
+			m_forward[k + offset] = x;
+
+			if (odd && backwardMin <= k && k <= backwardMax &&
+				m_backward[k + offset] <= x)
+			{
+				prevSplit = x;
+				curSplit = y;
+				return;
+			}
+		}
+
+		// Same again for the backward search
+		if (backwardMin > minDiagonal)
+		{
+			m_backward[--backwardMin - 1 + offset] = UNREACHED;
+		}
+		else
+		{
+			backwardMin++;
+		}
+
+		if (backwardMax < maxDiagonal)
+		{
+			m_backward[++backwardMax + 1 + offset] = UNREACHED;
+		}
+		else
+		{
+			backwardMax--;
+		}
+
+		for (int32 k = backwardMax; k >= backwardMin; k -= 2)
+		{
+			int32 low = m_backward[k - 1 + offset];
+			int32 high = m_backward[k + 1 + offset];
+			int32 x = (low < high) ? low : high - 1;
+			int32 y = x - k;
+
+			while (x > (int32)prevStart && y > (int32)curStart &&
+				   m_prev[x - 1] == m_cur[y - 1])
+			{
+				x--;
+				y--;
+			}
+
+			m_backward[k + offset] = x;
+
+			if (!odd && forwardMin <= k && k <= forwardMax &&
+				x <= m_forward[k + offset])
+			{
+				prevSplit = x;
+				curSplit = y;
+				return;
+			}
+		}
+
+		if (edits >= m_tooExpensive)
+		{
+			findGoodSplit(prevStart, prevEnd, curStart, curEnd,
+						  forwardMin, forwardMax, backwardMin, backwardMax,
+						  offset, prevSplit, curSplit);
+			return;
+		}
+	}
+}
+
+void DiffEngine::findGoodSplit(uint32 prevStart, uint32 prevEnd,
+							   uint32 curStart, uint32 curEnd,
+							   int32 forwardMin, int32 forwardMax,
+							   int32 backwardMin, int32 backwardMax,
+							   int32 offset,
+							   uint32& prevSplit, uint32& curSplit)
+{
+	// Take whichever of the forward and backward paths has covered the
+	// most ground so far. The result is no longer the shortest diff, but
+	// the time stays bounded for very different texts.
+	int32 forwardBest = -1;
+	int32 forwardBestX = 0;
+
+	for (int32 k = forwardMax; k >= forwardMin; k -= 2)
+	{
+		int32 x = min<int32>(m_forward[k + offset], prevEnd);
+		int32 y = x - k;
+
+		if ((int32)curEnd < y)
+		{
+			x = curEnd + k;
+			y = curEnd;
+		}
+
+		if (forwardBest < x + y)
+		{
+			forwardBest = x + y;
+			forwardBestX = x;
+		}
+	}
+
+	int32 backwardBest = UNREACHED;
+	int32 backwardBestX = 0;
+
+	for (int32 k = backwardMax; k >= backwardMin; k -= 2)
+	{
+		int32 x = max<int32>(prevStart, m_backward[k + offset]);
+		int32 y = x - k;
+
+		if (y < (int32)curStart)
+		{
+			x = curStart + k;
+			y = curStart;
+		}
+
+		if (x + y < backwardBest)
+		{
+			backwardBest = x + y;
+			backwardBestX = x;
+		}
+	}
+
+	if ((int32)(prevEnd + curEnd) - backwardBest < forwardBest - (int32)(prevStart + curStart))
+	{
+		prevSplit = forwardBestX;
+		curSplit = forwardBest - forwardBestX;
+	}
+	else
+	{
+		prevSplit = backwardBestX;
+		curSplit = backwardBest - backwardBestX;
+	}
+}
+
+void DiffEngine::shiftBoundaries(vector<uint32>& lines,
+								 vector<bool>& changed,
+								 vector<bool>& otherChanged)
+{
+	// Same approach as shift_boundaries() in GNU diff. i walks this side
+	// and j keeps track of the matching point on the other side.
+	int32 end = (int32)lines.size();
+	int32 i = 0;
+	int32 j = 0;
+
+	while (true)
+	{
+		// Find the start of the next run of changes
+		while (i < end && !changed[i])
+		{
+			while (isChanged(otherChanged, j++))
+			{
+			}
+
+			i++;
+		}
+
+		if (i == end)
+		{
+			break;
+		}
+
+		int32 start = i;
+
+		// Find the end of the run
+		while (isChanged(changed, ++i))
+		{
+		}
+
+		while (isChanged(otherChanged, j))
+		{
+			j++;
+		}
+
+		int32 runLength;
+		int32 corresponding;
+
+		do
+		{
+			runLength = i - start;
+
+			// Slide the run up while the line above it equals its last
+			// line, merging with any run it meets
+			while (start > 0 && lines[start - 1] == lines[i - 1])
+			{
+				changed[--start] = true;
+				changed[--i] = false;
+
+				while (isChanged(changed, start - 1))
+				{
+					start--;
+				}
+
+				while (isChanged(otherChanged, --j))
+				{
+				}
+			}
+
+			// The last position where the run lines up with a run of
+			// changes on the other side, end if there is none
+			corresponding = isChanged(otherChanged, j - 1) ? i : end;
+
+			// Then slide it down while its first line equals the line
+			// below it. Done second so unmerged runs end up at the bottom.
+			while (i != end && lines[start] == lines[i])
+			{
+				changed[start++] = false;
+				changed[i++] = true;
+
+				while (isChanged(changed, i))
+				{
+					i++;
+				}
+
+				while (isChanged(otherChanged, ++j))
+				{
+					corresponding = i;
+				}
+			}
+		}
+		while (runLength != i - start);
+
+		// Move the merged run back to line up with the other side's run
+		// if it can, so the two become a single change hunk
+		while (corresponding < i)
+		{
+			changed[--start] = true;
+			changed[--i] = false;
+
+			while (isChanged(otherChanged, --j))
+			{
+			}
+		}
+	}
+}
+
+bool DiffEngine::isChanged(vector<bool>& changed, int32 index)
+{
+	// Positions outside the text count as unchanged
+	return (index >= 0 && index < (int32)changed.size() && changed[index]);
+}
+
+void DiffEngine::countHunks()
+{
+	uint32 prevIndex = 0;
+	uint32 curIndex = 0;
+
+	while (prevIndex < m_removed.size() || curIndex < m_inserted.size())
+	{
+		uint32 removed = 0;
+		uint32 inserted = 0;
+
+		while (prevIndex < m_removed.size() && m_removed[prevIndex])
+		{
+			removed++;
+			prevIndex++;
+		}
+
+		while (curIndex < m_inserted.size() && m_inserted[curIndex])
+		{
+			inserted++;
+			curIndex++;
+		}
+
+		// The next lines on each side are a matching pair
+		if (removed == 0 && inserted == 0)
+		{
+			prevIndex++;
+			curIndex++;
+			continue;
+		}
+
+		// Same rules FileDiff applies to the 'a', 'c' and 'd' hunks
+		if (removed > 0 && inserted > 0)
+		{
+			m_linesChanged += max<uint32>(removed, inserted);
+		}
+		else if (inserted > 0)
+		{
+			m_linesAdded += inserted;
+		}
+		else
+		{
+			m_linesRemoved += removed;
+		}
+	}
+}
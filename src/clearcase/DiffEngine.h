@@ -0,0 +1,105 @@
+// DiffEngine.h
+
+#ifndef DIFF_ENGINE_H
+#define DIFF_ENGINE_H
+
+#include <ccsponge.h>
+#include <text/String.h>
+
+#include <vector>
+using namespace std;
+
+/*
+ * Line based diff of two texts using Myers' O(ND) algorithm in its linear
+ * space (middle snake) form. Follows GNU diff closely: lines found on only
+ * one side are set aside before the search, and when the texts are very
+ * different the search gives up on the shortest diff to bound the time.
+ *
+ * The result is summed up the same way FileDiff sums up the hunks printed
+ * by "cleartool diff -diff_format". Each run of differences between two
+ * matching lines is one hunk. A hunk with lines on both sides is a change
+ * of the larger side, otherwise it is an add or a remove.
+ *
+ * Like diff, runs of changes are slid up or down over equal lines where
+ * that merges them with a neighbouring run, so the hunks come out grouped
+ * the way diff would print them.
+ *
+ * Lines are compared byte for byte including their line terminator, so a
+ * last line without a newline differs from the same line with one.
+ *
+ * Not safe for access by multiple threads.
+ */
+class DiffEngine
+{
+public:
+	DiffEngine();
+	~DiffEngine();
+
+	/*
+	 * Compares the predecessor text with the current text and replaces
+	 * the counts with the result.
+	 */
+	void compare(const String& prevText, const String& curText);
+
+	uint32 getLinesAdded();
+	uint32 getLinesChanged();
+	uint32 getLinesRemoved();
+
+private:
+	DiffEngine(const DiffEngine& other) {}
+	DiffEngine& operator=(const DiffEngine& other) {}
+
+	struct LineKey
+	{
+		const char* data;
+		uint32 length;
+
+		bool operator<(const LineKey& other) const;
+	};
+
+	void splitLines(const String& text, vector<LineKey>& lines);
+	uint32 assignIds(vector<LineKey>& prevLines, vector<LineKey>& curLines);
+	void discardUnmatched(uint32 idCount);
+	void compareRange(uint32 prevStart, uint32 prevEnd,
+					  uint32 curStart, uint32 curEnd);
+	void findMiddle(uint32 prevStart, uint32 prevEnd,
+					uint32 curStart, uint32 curEnd,
+					uint32& prevSplit, uint32& curSplit);
+	void findGoodSplit(uint32 prevStart, uint32 prevEnd,
+					   uint32 curStart, uint32 curEnd,
+					   int32 forwardMin, int32 forwardMax,
+					   int32 backwardMin, int32 backwardMax,
+					   int32 offset,
+					   uint32& prevSplit, uint32& curSplit);
+	static void shiftBoundaries(vector<uint32>& lines,
+								vector<bool>& changed,
+								vector<bool>& otherChanged);
+	static bool isChanged(vector<bool>& changed, int32 index);
+	void countHunks();
+
+	// Each line replaced by a number that is equal for equal lines
+	vector<uint32> m_prevLines;
+	vector<uint32> m_curLines;
+
+	// The lines found on both sides, which are all the search looks at,
+	// and where each of them is in the full text
+	vector<uint32> m_prev;
+	vector<uint32> m_cur;
+	vector<uint32> m_prevLineNumbers;
+	vector<uint32> m_curLineNumbers;
+
+	// Lines that are not part of the common subsequence
+	vector<bool> m_removed;
+	vector<bool> m_inserted;
+
+	// Furthest reaching paths, reused between findMiddle() calls
+	vector<int32> m_forward;
+	vector<int32> m_backward;
+	int32 m_tooExpensive;
+
+	uint32 m_linesAdded;
+	uint32 m_linesChanged;
+	uint32 m_linesRemoved;
+};
+
+#endif // DIFF_ENGINE_H
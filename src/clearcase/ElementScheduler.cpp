@@ -0,0 +1,76 @@
+// ElementScheduler.cpp
+
+#include "ElementScheduler.h"
+
+ElementScheduler::ElementScheduler(ThreadPool* threadPool,
+								   Settings* settings,
+								   CleartoolSessionPool* sessionPool)
+{
+	m_threadPool = threadPool;
+	m_settings = settings;
+	m_sessionPool = sessionPool;
+	m_batch = NULL;
+}
+
+ElementScheduler::~ElementScheduler()
+{
+	flush();
+}
+
+void ElementScheduler::add(AnalyzeTask* analyzeTask)
+{
+	bool byElement = m_settings->getLocalDiff();
+	bool describeInBatch = (!analyzeTask->hasDescriptionRecord() &&
+							m_settings->getBatchSize() > 1);
+
+	// Nothing to gain from a batch, so the task can run on its own
+	if (!byElement && !describeInBatch)
+	{
+		m_threadPool->execute(analyzeTask);
+		return;
+	}
+
+	StringView elementName = getElementName(analyzeTask->getVersionName());
+
+	// Send off a full batch, but not in the middle of an element's versions
+	// when they are being compared in order
+	if (m_batch != NULL &&
+		m_batch->size() >= m_settings->getBatchSize() &&
+		(!byElement || !elementName.equals(m_lastElement)))
+	{
+		flush();
+	}
+
+	if (m_batch == NULL)
+	{
+		m_batch = new VersionBatchTask(m_sessionPool, m_settings->getBatchSize());
+	}
+
+	m_batch->add(analyzeTask);
+	m_lastElement.assign(elementName.data(), elementName.length());
+}
+
+void ElementScheduler::flush()
+{
+	if (m_batch == NULL)
+	{
+		return;
+	}
+
+	m_threadPool->execute(m_batch);
+	m_batch = NULL;
+}
+
+// Private functions --------------------------------------------------------
+
+StringView ElementScheduler::getElementName(const String& versionName)
+{
+	int32 atatIndex = versionName.indexOf("@@");
+
+	if (atatIndex < 0)
+	{
+		return StringView(versionName);
+	}
+
+	return StringView(versionName.c_str(), atatIndex);
+}
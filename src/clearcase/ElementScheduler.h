@@ -0,0 +1,66 @@
+// ElementScheduler.h
+
+#ifndef ELEMENT_SCHEDULER_H
+#define ELEMENT_SCHEDULER_H
+
+#include <ccsponge.h>
+#include <Settings.h>
+#include <clearcase/AnalyzeTask.h>
+#include <clearcase/CleartoolSessionPool.h>
+#include <clearcase/VersionBatchTask.h>
+#include <text/String.h>
+#include <text/StringView.h>
+#include <thread/ThreadPool.h>
+
+/*
+ * Hands the AnalyzeTasks created by CtFindTask and LsHistoryTask to the
+ * ThreadPool.
+ *
+ * Versions that still need describing are gathered into VersionBatchTasks
+ * so they can be described together. With -localdiff every version goes
+ * through a batch, and a batch is only sent off where a new element starts.
+ * All the versions of an element found together are then compared in order
+ * by one thread, so each version's text is still in the ContentCache when
+ * it is needed as the predecessor of the next.
+ *
+ * Not safe for access by multiple threads.
+ */
+class ElementScheduler
+{
+public:
+	ElementScheduler(ThreadPool* threadPool,
+					 Settings* settings,
+					 CleartoolSessionPool* sessionPool);
+
+	/*
+	 * Sends off the last batch if flush() wasn't called.
+	 */
+	~ElementScheduler();
+
+	/*
+	 * Queues up a task. The AnalyzeTask must be allocated with new and is
+	 * deleted once it has run.
+	 */
+	void add(AnalyzeTask* analyzeTask);
+
+	/*
+	 * Sends off the batch being gathered. Call once all the tasks have been
+	 * added.
+	 */
+	void flush();
+
+private:
+	ElementScheduler(const ElementScheduler& other) {}
+	ElementScheduler& operator=(const ElementScheduler& other) {}
+
+	static StringView getElementName(const String& versionName);
+
+private:
+	ThreadPool* m_threadPool;
+	Settings* m_settings;
+	CleartoolSessionPool* m_sessionPool;
+	VersionBatchTask* m_batch; // Versions waiting to be run together
+	String m_lastElement; // Element of the last version added to m_batch
+};
+
+#endif // ELEMENT_SCHEDULER_H
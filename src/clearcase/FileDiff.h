@@ -4,15 +4,19 @@
 #define FILE_DIFF_H
 
 #include <ccsponge.h>
+#include <clearcase/DiffCounter.h>
 #include <text/String.h>
+#include <text/StringView.h>
 
 /**
  * Represents the difference of two files as produced by "cleartool diff".
+ *
+ * The version name is not copied, so it has to outlive the FileDiff.
  */
 class FileDiff
 {
 public:
-	FileDiff(String version);
+	FileDiff(const String& version);
 	~FileDiff();
 
 	/*
@@ -20,26 +24,41 @@ public:
 	 *
 	 * Throws ParsingException if the text doesn't match the expected format.
 	 */
-	void populate(String diffText);
+	void populate(const String& diffText);
 
-	String getVersion();
+	/*
+	 * Same as above for diff text that isn't in a String. The text is read
+	 * once from start to end and isn't copied.
+	 */
+	void populate(const char* diffText, uint32 length);
+
+	/*
+	 * Populates with the totals of a counter that has been written all of
+	 * the "cleartool diff" output.
+	 *
+	 * Throws ParsingException if the text didn't match the expected format.
+	 */
+	void populate(DiffCounter& counter);
+
+	/*
+	 * Populates by comparing the predecessor's text with this version's
+	 * text directly. The counts come from a shortest edit script and can
+	 * differ from those "cleartool diff" gives for the same two versions.
+	 */
+	void populate(const String& prevText, const String& curText);
+
+	/*
+	 * Populates with counts worked out earlier.
+	 */
+	void populate(uint32 linesAdded, uint32 linesChanged, uint32 linesRemoved);
+
+	StringView getVersion() const;
 	uint32 getLinesAdded();
 	uint32 getLinesChanged();
 	uint32 getLinesRemoved();
 
 private:
-	struct DiffRange
-	{
-		uint32 min;
-		uint32 max;
-	};
-
-	DiffRange readRange(String diffText, uint32& index, bool& success);
-	uint32 readNumber(String diffText, uint32& index, bool& success);
-	void skipDiff(String diffText, uint32& index);
-	void nextLine(String diffText, uint32& index);
-
-	String m_version;
+	StringView m_version;
 	uint32 m_linesAdded;
 	uint32 m_linesChanged;
 	uint32 m_linesRemoved;
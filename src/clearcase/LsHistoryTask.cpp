@@ -0,0 +1,378 @@
+// LsHistoryTask.cpp
+
+#include "LsHistoryTask.h"
+#include <clearcase/CtFindTask.h>
+#include <exception/ParsingException.h>
+#include <io/BufferedReader.h>
+#include <io/InputStream.h>
+#include <thread/Process.h>
+
+#include <ctype.h> // For isdigit()
+#include <iostream>
+#include <vector>
+using namespace std;
+
+// Each history event is the operation followed by a description record:
+// checkin<TAB>/vobs/sw/file.c@@/main/br/3<TAB>20060908.165714<TAB>...
+#define HISTORY_FORMAT "%o\\t" DESCRIPTION_FORMAT
+
+// The operation that creates a new version
+#define CHECKIN_OPERATION "checkin"
+
+// Month abbreviations accepted in dates like 08-Sep-2006
+const char* const monthNames[] = {"jan", "feb", "mar", "apr", "may", "jun",
+	"jul", "aug", "sep", "oct", "nov", "dec"};
+
+
+LsHistoryTask::LsHistoryTask(ThreadPool* threadPool,
+							 DataStore* dataStore,
+							 Settings* settings,
+							 CleartoolSessionPool* sessionPool,
+							 ContentCache* contentCache,
+							 ResultCache* resultCache,
+							 ProgressJournal* journal) :
+	m_scheduler(threadPool, settings, sessionPool)
+{
+	m_threadPool = threadPool;
+	m_dataStore = dataStore;
+	m_settings = settings;
+	m_sessionPool = sessionPool;
+	m_contentCache = contentCache;
+	m_resultCache = resultCache;
+	m_journal = journal;
+}
+
+LsHistoryTask::~LsHistoryTask()
+{
+
+}
+
+void LsHistoryTask::run()
+{
+	// The -before date has to be compared here, so it has to be a date we
+	// can read ourselves
+	String beforeDate = m_settings->getBeforeDate();
+
+	if (beforeDate.length() > 0 &&
+		!parseDateLimit(beforeDate, m_beforeLimit))
+	{
+		cerr << "Unsupported date for -before with -lshistory: " << beforeDate
+			<< endl << "Use a date like 2006-09-08 or 08-Sep-2006." << endl;
+		exit(1);
+	}
+
+	// Build command string
+	String command = makeQuery();
+
+	// Execute the query in another process
+	Process historyProcess;
+	historyProcess.execCommand(command, true);
+
+	InputStream* stdOutStream = historyProcess.getStdOut();
+	BufferedReader historyReader(stdOutStream);
+	bool readSuccess;
+
+	// Extract the first returned event
+	String line = historyReader.readLine(readSuccess);
+
+	// If the returned string is empty just return as we found nothing
+	if (!readSuccess)
+	{
+		return;
+	}
+
+	// Skip warning on systems that have configuration issues
+	// Can start with a string like:
+	// noname: Warning: Can not find a group named "xxx\yyy"
+	if (line.startsWith("noname: Warning:"))
+	{
+		line = historyReader.readLine(readSuccess);
+
+		if (!readSuccess)
+		{
+			return;
+		}
+	}
+
+	// Print errors returned from cleartool
+	if (line.startsWith("cleartool: Error:"))
+	{
+		cerr << "Failed to execute cleartool lshistory command. Aborting." << endl
+			<< line << endl;
+		exit(1);
+	}
+
+	analyze(line);
+
+	// Loop to analyze remaining events. Each line is copied straight out
+	// of the reader's buffer into the String the AnalyzeTask takes over.
+	const char* data;
+	uint32 length;
+
+	while (historyReader.readLine(data, length))
+	{
+		line.assign(data, length);
+		analyze(line);
+	}
+
+	// Send off the last partial batch
+	m_scheduler.flush();
+
+	// Wait for the lshistory process to exit
+	historyProcess.waitFor();
+}
+
+// Private functions --------------------------------------------------------
+
+void LsHistoryTask::analyze(String& line)
+{
+	// Only checkins create versions. Branch and element creation events
+	// are ignored, as is anything that isn't an event at all.
+	String operation(CHECKIN_OPERATION);
+	operation.append('\t');
+
+	if (!line.startsWith(operation))
+	{
+		return;
+	}
+
+	String record = line.subString(operation.length());
+	Description description;
+
+	try
+	{
+		description.populateFromRecord(record);
+	}
+	catch (ParsingException& e)
+	{
+		cout << "Error: Failed to parse 'cleartool lshistory' event: "
+			<< e.what() << endl;
+		return;
+	}
+
+	if (!m_settings->getFilter().passes(description.m_versionName) ||
+		!passesFilters(description))
+	{
+		return;
+	}
+
+	// The one copy of the name, made while the record it points into is
+	// still intact. Both are handed over to the AnalyzeTask.
+	String versionName = description.m_versionName.toString();
+
+	// Already counted by the run being resumed
+	if (m_journal->contains(versionName))
+	{
+		return;
+	}
+
+	AnalyzeTask* analyzeTask = new AnalyzeTask(m_threadPool,
+		m_dataStore,
+		m_settings,
+		m_sessionPool,
+		m_contentCache,
+		m_resultCache,
+		m_journal,
+		versionName,
+		record);
+	m_scheduler.add(analyzeTask);
+}
+
+bool LsHistoryTask::passesFilters(Description& description)
+{
+	// Equivalent of the created_by() filter
+	const vector<String>& users = m_settings->getUsers();
+
+	if (users.size() > 0)
+	{
+		bool userFound = false;
+
+		for (uint32 i = 0; i < users.size() && !userFound; i++)
+		{
+			userFound = description.m_user.equals(users[i]);
+		}
+
+		if (!userFound)
+			return false;
+	}
+
+	// Equivalent of the brtype() and !brtype(main) filters
+	StringView branchType = getBranchType(description.m_versionName);
+	const vector<String>& brtypes = m_settings->getBrtypes();
+
+	if (brtypes.size() > 0)
+	{
+		bool brtypeFound = false;
+
+		for (uint32 i = 0; i < brtypes.size() && !brtypeFound; i++)
+		{
+			brtypeFound = branchType.equals(brtypes[i]);
+		}
+
+		if (!brtypeFound)
+			return false;
+	}
+
+	if (m_settings->getMainExcluded() && branchType.equals("main"))
+	{
+		return false;
+	}
+
+	// Equivalent of !created_since(), which is at or after the limit. The
+	// record date is local time, as is the limit, so the ISO text compares
+	// correctly as a plain string.
+	if (m_beforeLimit.length() > 0)
+	{
+		String created = description.m_createDate + 'T' + description.m_createTime;
+
+		if (created >= m_beforeLimit)
+			return false;
+	}
+
+	// Equivalent of !hltype(Merge, ->)
+	if (m_settings->getMergesExcluded() && description.m_mergeTo)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+String LsHistoryTask::makeQuery()
+{
+	// Parameters:
+	// -recurse - list the history of everything below each path
+	// -nco - leave out checked out versions
+	// -since - equivalent of created_since() in the find query
+	String command("cleartool lshistory -recurse -nco -fmt ");
+	command.append(ARG_QUOTE_CHAR);
+	command.append(HISTORY_FORMAT);
+	command.append(ARG_QUOTE_CHAR);
+
+	// lshistory takes a single -since, so the high-water mark of restored
+	// -incremental state takes the place of -after. Everything it counted
+	// was created after the -after date of the run that saved it.
+	String afterDate = m_dataStore->getSinceDate();
+
+	if (afterDate.length() == 0)
+	{
+		afterDate = m_settings->getAfterDate();
+	}
+
+	if (afterDate.length() > 0)
+	{
+		command.append(" -since ");
+		command.append(afterDate);
+	}
+
+	const vector<String>& paths = m_settings->getPaths();
+
+	for (uint32 i = 0; i < paths.size(); i++)
+	{
+		command.append(' ');
+		command.append(paths[i]);
+	}
+
+	return command;
+}
+
+StringView LsHistoryTask::getBranchType(const StringView& versionName)
+{
+	// The brtype is the last branch in the version's branch path:
+	// /vobs/sw/file.c@@/main/fixes/3 is on brtype "fixes"
+	int32 numberStart = versionName.lastIndexOf('/');
+	int32 atatIndex = versionName.indexOf("@@");
+
+	if (numberStart <= atatIndex + 2)
+	{
+		return StringView();
+	}
+
+	int32 branchStart = versionName.subView(0, numberStart).lastIndexOf('/');
+	return versionName.subView(branchStart + 1, numberStart);
+}
+
+bool LsHistoryTask::parseDateLimit(const String& date, String& isoLimit)
+{
+	uint32 year;
+	uint32 month;
+	uint32 day;
+	uint32 timeStart;
+	bool isInt = true;
+	bool success = true;
+
+	if (date.length() >= 10 && date.charAt(4) == '-' && date.charAt(7) == '-')
+	{
+		// 2006-09-08 or 2006-09-08T16:57:14
+		year = date.subString(0, 4).toUInt32(isInt);
+		success &= isInt;
+		month = date.subString(5, 7).toUInt32(isInt);
+		success &= isInt;
+		day = date.subString(8, 10).toUInt32(isInt);
+		success &= isInt;
+		timeStart = 11;
+	}
+	else
+	{
+		// 08-Sep-2006, 8-Sep-06 or 08-Sep-2006.16:57:14
+		int32 dash1 = date.indexOf('-');
+		int32 dash2 = date.indexOf('-', dash1 + 1);
+
+		if (dash1 < 1 || dash2 != dash1 + 4)
+			return false;
+
+		day = date.subString(0, dash1).toUInt32(isInt);
+		success &= isInt;
+
+		String monthName = date.subString(dash1 + 1, dash2);
+		month = 0;
+
+		for (uint32 i = 0; i < 12 && month == 0; i++)
+		{
+			if (monthName.equalsIgnoringCase(monthNames[i]))
+				month = i + 1;
+		}
+
+		int32 yearEnd = date.indexOf('.', dash2);
+		if (yearEnd < 0)
+			yearEnd = date.length();
+
+		year = date.subString(dash2 + 1, yearEnd).toUInt32(isInt);
+		success &= isInt;
+
+		// Two digit years, the same window cleartool uses
+		if (yearEnd - dash2 - 1 == 2)
+			year += (year < 70) ? 2000 : 1900;
+
+		timeStart = yearEnd + 1;
+	}
+
+	if (!success || month < 1 || month > 12 || day < 1 || day > 31)
+	{
+		return false;
+	}
+
+	// The time is optional and defaults to the start of the day
+	String time("00:00:00");
+
+	if (timeStart < date.length())
+	{
+		time = date.subString(timeStart);
+
+		if (time.length() == 5)
+			time.append(":00");
+
+		if (time.length() != 8 || time.charAt(2) != ':' || time.charAt(5) != ':')
+			return false;
+	}
+
+	isoLimit.clear();
+	isoLimit.append(year);
+	isoLimit.append(month < 10 ? "-0" : "-");
+	isoLimit.append(month);
+	isoLimit.append(day < 10 ? "-0" : "-");
+	isoLimit.append(day);
+	isoLimit.append('T');
+	isoLimit.append(time);
+	return true;
+}
@@ -0,0 +1,61 @@
+// LsHistoryTask.h
+
+#ifndef LS_HISTORY_TASK_H
+#define LS_HISTORY_TASK_H
+
+#include <Settings.h>
+#include <clearcase/AnalyzeTask.h>
+#include <clearcase/CleartoolSessionPool.h>
+#include <clearcase/ContentCache.h>
+#include <clearcase/DataStore.h>
+#include <clearcase/Description.h>
+#include <clearcase/ElementScheduler.h>
+#include <clearcase/ProgressJournal.h>
+#include <clearcase/ResultCache.h>
+#include <text/String.h>
+#include <text/StringView.h>
+#include <thread/ThreadPool.h>
+#include <util/Runnable.h>
+
+/*
+ * An alternative to CtFindTask that finds versions with a single streaming
+ * "cleartool lshistory -recurse" over the user's paths. Every checkin event
+ * comes out already described, so no describe is run for any version, and
+ * event history scans are cheaper for the VOB server than a find.
+ *
+ * lshistory has no query language, so apart from -after (passed as -since)
+ * the user filters are applied here as the events stream in.
+ */
+class LsHistoryTask : public Runnable
+{
+public:
+	LsHistoryTask(ThreadPool* threadPool,
+				  DataStore* dataStore,
+				  Settings* settings,
+				  CleartoolSessionPool* sessionPool,
+				  ContentCache* contentCache,
+				  ResultCache* resultCache,
+				  ProgressJournal* journal);
+	~LsHistoryTask();
+
+	void run();
+
+private:
+	void analyze(String& line);
+	bool passesFilters(Description& description);
+	String makeQuery();
+	static StringView getBranchType(const StringView& versionName);
+	static bool parseDateLimit(const String& date, String& isoLimit);
+
+	ThreadPool* m_threadPool;
+	DataStore* m_dataStore;
+	Settings* m_settings;
+	CleartoolSessionPool* m_sessionPool;
+	ContentCache* m_contentCache;
+	ResultCache* m_resultCache;
+	ProgressJournal* m_journal;
+	ElementScheduler m_scheduler;
+	String m_beforeLimit; // -before as YYYY-MM-DDTHH:MM:SS, empty if none
+};
+
+#endif // LS_HISTORY_TASK_H
@@ -0,0 +1,296 @@
+// ProgressJournal.cpp
+
+#include "ProgressJournal.h"
+#include <clearcase/AnalyzeTask.h>
+#include <exception/IOException.h>
+#include <io/FileInputStream.h>
+#include <util/Locker.h>
+
+#include <iostream>
+using namespace std;
+
+// The number of tab delimited fields in a line
+#define LINE_FIELD_COUNT 7
+
+// The second field of the line of a version that was skipped
+#define SKIPPED_MARKER "skipped"
+
+// How much of the file to read at a time when loading
+#define READ_BUFFER_SIZE 65536
+
+// How many lines to write between syncs. Syncing every line would make
+// each worker wait on the disk once per version.
+#define SYNC_INTERVAL 64
+
+
+ProgressJournal::ProgressJournal()
+{
+	m_isOpen = false;
+	m_unsyncedCount = 0;
+}
+
+ProgressJournal::~ProgressJournal()
+{
+	try
+	{
+		close();
+	}
+	catch (exception&)
+	{
+	}
+}
+
+void ProgressJournal::open(const String& fileName, bool resume)
+{
+	Locker locker(m_mutex);
+
+	if (!resume)
+	{
+		m_outputStream.open(fileName, false);
+		m_isOpen = true;
+		return;
+	}
+
+	// Opening for append first creates the file if it's missing
+	m_outputStream.open(fileName, true);
+	m_isOpen = true;
+
+	// The run being resumed may have died half way through a line.
+	// Finish it so the next version starts on a line of its own.
+	if (!load(fileName))
+	{
+		m_outputStream.write("\n", 1);
+	}
+}
+
+void ProgressJournal::replay(DataStore& dataStore)
+{
+	Locker locker(m_mutex);
+
+	for (uint32 i = 0; i < m_entries.size(); i++)
+	{
+		Entry& entry = m_entries[i];
+
+		bool dateParsed;
+		Date date = AnalyzeTask::parseDate(entry.createDate,
+			entry.createTime,
+			dataStore.getUtcOffsets(),
+			dateParsed);
+
+		if (!dateParsed ||
+			!dataStore.claimVersion(entry.createDate + 'T' + entry.createTime))
+		{
+			continue;
+		}
+
+		// Claimed like any other, but there is nothing to count
+		if (entry.linesAdded == 0 &&
+			entry.linesChanged == 0 &&
+			entry.linesRemoved == 0)
+		{
+			continue;
+		}
+
+		FileDiff fileDiff(entry.versionName);
+		fileDiff.populate(entry.linesAdded,
+			entry.linesChanged,
+			entry.linesRemoved);
+
+		dataStore.addData(date, fileDiff, entry.user);
+	}
+
+	// Only the names are needed from here on
+	m_entries.clear();
+}
+
+bool ProgressJournal::contains(const String& versionName)
+{
+	Locker locker(m_mutex);
+	return (m_versionNames.find(versionName) != m_versionNames.end());
+}
+
+void ProgressJournal::add(const String& versionName,
+						  const String& createDate,
+						  const String& createTime,
+						  const String& user,
+						  FileDiff& fileDiff)
+{
+	Locker locker(m_mutex);
+
+	if (!m_isOpen)
+	{
+		return;
+	}
+
+	String line(versionName);
+	line.append('\t');
+	line.append(createDate);
+	line.append('\t');
+	line.append(createTime);
+	line.append('\t');
+	line.append(fileDiff.getLinesAdded());
+	line.append('\t');
+	line.append(fileDiff.getLinesChanged());
+	line.append('\t');
+	line.append(fileDiff.getLinesRemoved());
+	line.append('\t');
+	line.append(user);
+	line.append('\n');
+
+	writeLine(line);
+}
+
+void ProgressJournal::addSkipped(const String& versionName)
+{
+	Locker locker(m_mutex);
+
+	if (!m_isOpen)
+	{
+		return;
+	}
+
+	String line(versionName);
+	line.append('\t');
+	line.append(SKIPPED_MARKER);
+	line.append('\n');
+
+	writeLine(line);
+}
+
+void ProgressJournal::close()
+{
+	Locker locker(m_mutex);
+
+	if (!m_isOpen)
+	{
+		return;
+	}
+
+	m_isOpen = false;
+
+	if (m_unsyncedCount > 0)
+	{
+		m_unsyncedCount = 0;
+		m_outputStream.sync();
+	}
+
+	m_outputStream.close();
+}
+
+// Private functions --------------------------------------------------------
+
+bool ProgressJournal::load(const String& fileName)
+{
+	FileInputStream inputStream;
+	inputStream.open(fileName);
+
+	char buffer[READ_BUFFER_SIZE];
+	int64 bytesRead;
+	String line;
+
+	while ((bytesRead = inputStream.read(buffer, READ_BUFFER_SIZE)) > 0)
+	{
+		uint32 lineStart = 0;
+
+		for (uint32 i = 0; i < (uint32)bytesRead; i++)
+		{
+			if (buffer[i] != '\n')
+			{
+				continue;
+			}
+
+			line.append(buffer + lineStart, i - lineStart);
+
+			if (line.length() > 0 && !parseLine(line))
+			{
+				cout << "Ignoring damaged journal line: " << line.c_str() << endl;
+			}
+
+			line = String();
+			lineStart = i + 1;
+		}
+
+		// Keep the start of a line that continues in the next read
+		line.append(buffer + lineStart, (uint32)bytesRead - lineStart);
+	}
+
+	inputStream.close();
+
+	// Anything left over wasn't terminated by a newline, so its version
+	// wasn't completely recorded and has to be analyzed again
+	return (line.length() == 0);
+}
+
+bool ProgressJournal::parseLine(const String& line)
+{
+	String fields[LINE_FIELD_COUNT];
+	uint32 fieldCount = 0;
+	uint32 fieldStart = 0;
+
+	while (fieldCount < LINE_FIELD_COUNT && fieldStart <= line.length())
+	{
+		int32 fieldEnd = line.indexOf('\t', fieldStart);
+
+		// The last field runs to the end of the line
+		if (fieldEnd < 0 || fieldCount == LINE_FIELD_COUNT - 1)
+		{
+			fieldEnd = line.length();
+		}
+
+		fields[fieldCount++] = line.subString(fieldStart, fieldEnd);
+		fieldStart = fieldEnd + 1;
+	}
+
+	// A skipped version only needs to be known
+	if (fieldCount == 2 && fields[1].equals(SKIPPED_MARKER))
+	{
+		m_versionNames.insert(fields[0]);
+		return true;
+	}
+
+	// Lines from before the user was recorded have one field less
+	if (fieldCount < LINE_FIELD_COUNT - 1)
+	{
+		return false;
+	}
+
+	Entry entry;
+	entry.versionName = fields[0];
+	entry.createDate = fields[1];
+	entry.createTime = fields[2];
+	entry.user = fields[6];
+
+	bool addedIsInt = true;
+	bool changedIsInt = true;
+	bool removedIsInt = true;
+	entry.linesAdded = fields[3].toUInt32(addedIsInt);
+	entry.linesChanged = fields[4].toUInt32(changedIsInt);
+	entry.linesRemoved = fields[5].toUInt32(removedIsInt);
+
+	if (!addedIsInt || !changedIsInt || !removedIsInt)
+	{
+		return false;
+	}
+
+	// A version is only counted once, even if it was somehow recorded twice
+	if (!m_versionNames.insert(entry.versionName).second)
+	{
+		return true;
+	}
+
+	m_entries.push_back(entry);
+	return true;
+}
+
+void ProgressJournal::writeLine(const String& line)
+{
+	// One write per line so a killed run leaves at most one partial line
+	m_outputStream.write(line.c_str(), line.length());
+	m_unsyncedCount++;
+
+	if (m_unsyncedCount >= SYNC_INTERVAL)
+	{
+		m_outputStream.sync();
+		m_unsyncedCount = 0;
+	}
+}
@@ -0,0 +1,112 @@
+// ProgressJournal.h
+
+#ifndef PROGRESS_JOURNAL_H
+#define PROGRESS_JOURNAL_H
+
+#include <ccsponge.h>
+#include <clearcase/DataStore.h>
+#include <clearcase/FileDiff.h>
+#include <io/FileOutputStream.h>
+#include <text/String.h>
+#include <thread/Mutex.h>
+
+#include <set>
+#include <vector>
+using namespace std;
+
+/*
+ * An append-only record of the versions a run has finished, so a run that
+ * dies part way through can be resumed instead of started over. Each
+ * version diffed, changed or not, is one tab delimited line:
+ *
+ * name, date, time, added, changed, removed, user
+ *
+ * Lines written before the user was recorded have no user field. Versions
+ * that are skipped (directories, symbolic links and binary files) are a
+ * line of the name and "skipped". Versions that failed are not recorded,
+ * so a resumed run tries them again.
+ *
+ * Lines are written as soon as the version is counted, but only synced to
+ * disk every few lines. A crash can lose the last unsynced lines, and
+ * those versions are simply analyzed again by the resumed run.
+ *
+ * Until open() is called the journal is empty and add() does nothing.
+ *
+ * All public functions are thread safe.
+ */
+class ProgressJournal
+{
+public:
+	ProgressJournal();
+	~ProgressJournal();
+
+	/*
+	 * Opens the journal, creating it if it doesn't exist. With resume the
+	 * versions already in it are loaded and kept, otherwise it is emptied.
+	 *
+	 * Throws IOException if the file can't be read or written.
+	 */
+	void open(const String& fileName, bool resume);
+
+	/*
+	 * Adds the counts of every version loaded by open() to the data store.
+	 * Versions without changes add nothing, but are still claimed so the
+	 * high-water mark ends up where the run being resumed would have put
+	 * it.
+	 */
+	void replay(DataStore& dataStore);
+
+	/*
+	 * Returns true if the version was finished by the run being resumed.
+	 */
+	bool contains(const String& versionName);
+
+	/*
+	 * Records a version whose counts were just added to the data store,
+	 * or that was found to have no changes.
+	 */
+	void add(const String& versionName,
+			 const String& createDate,
+			 const String& createTime,
+			 const String& user,
+			 FileDiff& fileDiff);
+
+	/*
+	 * Records a version that was skipped without being diffed.
+	 */
+	void addSkipped(const String& versionName);
+
+	/*
+	 * Syncs and closes the journal.
+	 */
+	void close();
+
+private:
+	ProgressJournal(const ProgressJournal& other) {}
+	ProgressJournal& operator=(const ProgressJournal& other) {}
+
+	struct Entry
+	{
+		String versionName;
+		String createDate; // YYYY-MM-DD
+		String createTime; // HH:MM:SS, then the UTC offset if known
+		uint32 linesAdded;
+		uint32 linesChanged;
+		uint32 linesRemoved;
+		String user;
+	};
+
+	bool load(const String& fileName);
+	bool parseLine(const String& line);
+	void writeLine(const String& line);
+
+private:
+	Mutex m_mutex;
+	set<String> m_versionNames;
+	vector<Entry> m_entries;
+	FileOutputStream m_outputStream;
+	bool m_isOpen;
+	uint32 m_unsyncedCount;
+};
+
+#endif // PROGRESS_JOURNAL_H
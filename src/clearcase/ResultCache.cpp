@@ -0,0 +1,208 @@
+// ResultCache.cpp
+
+#include "ResultCache.h"
+#include <io/FileInputStream.h>
+#include <util/Locker.h>
+
+// The number of tab delimited fields in a line
+#define LINE_FIELD_COUNT 11
+
+// How much of the file to read at a time when loading
+#define READ_BUFFER_SIZE 65536
+
+// Names of the outcomes in the file, in Outcome order
+const char* const outcomeNames[] = {"changed", "unchanged", "directory",
+	"symlink", "binary"};
+#define OUTCOME_COUNT 5
+
+// Names of the diff modes in the file, in DiffMode order
+const char* const diffModeNames[] = {"diff", "headersonly", "localdiff"};
+
+
+ResultCache::ResultCache()
+{
+	m_diffMode = CLEARTOOL_DIFF;
+	m_writer = NULL;
+}
+
+ResultCache::~ResultCache()
+{
+	delete m_writer;
+	m_outputStream.close();
+}
+
+void ResultCache::open(const String& fileName, DiffMode diffMode)
+{
+	Locker locker(m_mutex);
+
+	m_diffMode = diffMode;
+
+	// Opening for append first creates the file if it's missing
+	m_outputStream.open(fileName, true);
+	m_writer = new TextWriter(&m_outputStream);
+
+	// A run that was killed can leave half a line at the end. Finish it so
+	// the next result starts on a line of its own.
+	if (!load(fileName))
+	{
+		m_writer->write("\n");
+	}
+}
+
+bool ResultCache::find(const String& versionName, Entry& entry)
+{
+	Locker locker(m_mutex);
+
+	map<String, Entry>::iterator iter = m_entries.find(versionName);
+
+	if (iter == m_entries.end())
+	{
+		return false;
+	}
+
+	entry = iter->second;
+	return true;
+}
+
+void ResultCache::add(const String& versionName, const Entry& entry)
+{
+	Locker locker(m_mutex);
+
+	if (m_writer == NULL ||
+		!m_entries.insert(make_pair(versionName, entry)).second)
+	{
+		return;
+	}
+
+	m_writer->write(makeLine(versionName, entry));
+}
+
+// Private functions --------------------------------------------------------
+
+bool ResultCache::load(const String& fileName)
+{
+	FileInputStream inputStream;
+	inputStream.open(fileName);
+
+	char buffer[READ_BUFFER_SIZE];
+	int64 bytesRead;
+	String line;
+
+	while ((bytesRead = inputStream.read(buffer, READ_BUFFER_SIZE)) > 0)
+	{
+		uint32 lineStart = 0;
+
+		for (uint32 i = 0; i < (uint32)bytesRead; i++)
+		{
+			if (buffer[i] != '\n')
+			{
+				continue;
+			}
+
+			line.append(buffer + lineStart, i - lineStart);
+			parseLine(line);
+			line = String();
+			lineStart = i + 1;
+		}
+
+		// Keep the start of a line that continues in the next read
+		line.append(buffer + lineStart, (uint32)bytesRead - lineStart);
+	}
+
+	inputStream.close();
+
+	// Anything left over wasn't terminated by a newline
+	return (line.length() == 0);
+}
+
+bool ResultCache::parseLine(const String& line)
+{
+	String fields[LINE_FIELD_COUNT];
+	uint32 fieldStart = 0;
+
+	for (uint32 i = 0; i < LINE_FIELD_COUNT; i++)
+	{
+		int32 fieldEnd = line.indexOf('\t', fieldStart);
+
+		// The last field runs to the end of the line
+		if (i == LINE_FIELD_COUNT - 1)
+		{
+			fieldEnd = line.length();
+		}
+		else if (fieldEnd < 0)
+		{
+			return false;
+		}
+
+		fields[i] = line.subString(fieldStart, fieldEnd);
+		fieldStart = fieldEnd + 1;
+	}
+
+	Entry entry;
+	uint32 outcome = 0;
+
+	while (outcome < OUTCOME_COUNT && !fields[1].equals(outcomeNames[outcome]))
+	{
+		outcome++;
+	}
+
+	if (outcome == OUTCOME_COUNT)
+	{
+		return false;
+	}
+
+	// Counts worked out another way would change this run's totals
+	if (!fields[2].equals(diffModeNames[m_diffMode]))
+	{
+		return true;
+	}
+
+	entry.outcome = (Outcome)outcome;
+	entry.createDate = fields[3];
+	entry.createTime = fields[4];
+	entry.user = fields[5];
+	entry.predecessor = fields[6];
+	entry.mergeTo = fields[7].equals("1");
+
+	bool addedIsInt = true;
+	bool changedIsInt = true;
+	bool removedIsInt = true;
+	entry.linesAdded = fields[8].toUInt32(addedIsInt);
+	entry.linesChanged = fields[9].toUInt32(changedIsInt);
+	entry.linesRemoved = fields[10].toUInt32(removedIsInt);
+
+	if (!addedIsInt || !changedIsInt || !removedIsInt)
+	{
+		return false;
+	}
+
+	m_entries[fields[0]] = entry;
+	return true;
+}
+
+String ResultCache::makeLine(const String& versionName, const Entry& entry)
+{
+	String line(versionName);
+	line.append('\t');
+	line.append(outcomeNames[entry.outcome]);
+	line.append('\t');
+	line.append(diffModeNames[m_diffMode]);
+	line.append('\t');
+	line.append(entry.createDate);
+	line.append('\t');
+	line.append(entry.createTime);
+	line.append('\t');
+	line.append(entry.user);
+	line.append('\t');
+	line.append(entry.predecessor);
+	line.append('\t');
+	line.append(entry.mergeTo ? "1" : "0");
+	line.append('\t');
+	line.append(entry.linesAdded);
+	line.append('\t');
+	line.append(entry.linesChanged);
+	line.append('\t');
+	line.append(entry.linesRemoved);
+	line.append('\n');
+	return line;
+}
@@ -0,0 +1,109 @@
+// ResultCache.h
+
+#ifndef RESULT_CACHE_H
+#define RESULT_CACHE_H
+
+#include <ccsponge.h>
+#include <io/FileOutputStream.h>
+#include <io/TextWriter.h>
+#include <text/String.h>
+#include <thread/Mutex.h>
+
+#include <map>
+using namespace std;
+
+/*
+ * A file of analysis results kept between runs. Checked in versions never
+ * change, so once a version has been described and diffed the result can
+ * be looked up by version extended name instead of asking cleartool again.
+ *
+ * Each result is one tab delimited line, appended to the file as soon as
+ * it is known:
+ *
+ * name, outcome, diff mode, date, time, user, predecessor, merged to,
+ * added, changed, removed
+ *
+ * The diff mode says how the counts were worked out. -localdiff and
+ * -headersonly counts can differ from a full "cleartool diff", so only the
+ * results of the same mode as the run are loaded.
+ *
+ * Versions that are skipped (directories, symbolic links and binary files)
+ * and versions without changes are recorded too. Errors are not, as they
+ * may not happen the next time.
+ *
+ * Until open() is called the cache is empty and add() does nothing.
+ *
+ * All public functions are thread safe.
+ */
+class ResultCache
+{
+public:
+	enum Outcome
+	{
+		CHANGED,
+		UNCHANGED,
+		DIRECTORY,
+		SYMBOLIC_LINK,
+		BINARY,
+	};
+
+	enum DiffMode
+	{
+		CLEARTOOL_DIFF,
+		HEADERS_ONLY,
+		LOCAL_DIFF,
+	};
+
+	struct Entry
+	{
+		Outcome outcome;
+		String createDate; // YYYY-MM-DD
+		String createTime; // HH:MM:SS, then the UTC offset if known
+		String user;
+		String predecessor;
+		bool mergeTo;
+		uint32 linesAdded;
+		uint32 linesChanged;
+		uint32 linesRemoved;
+	};
+
+	ResultCache();
+	~ResultCache();
+
+	/*
+	 * Loads the results in the file found with diffMode, creating the file
+	 * if it doesn't exist, and keeps it open to append new results to.
+	 * Results found with any other mode are left in the file but ignored.
+	 *
+	 * Throws IOException if the file can't be read or written.
+	 */
+	void open(const String& fileName, DiffMode diffMode);
+
+	/*
+	 * Copies the cached result for the version to entry. Returns false if
+	 * there is none.
+	 */
+	bool find(const String& versionName, Entry& entry);
+
+	/*
+	 * Records the result for a version, in memory and in the file.
+	 */
+	void add(const String& versionName, const Entry& entry);
+
+private:
+	ResultCache(const ResultCache& other) {}
+	ResultCache& operator=(const ResultCache& other) {}
+
+	bool load(const String& fileName);
+	bool parseLine(const String& line);
+	String makeLine(const String& versionName, const Entry& entry);
+
+private:
+	Mutex m_mutex;
+	DiffMode m_diffMode;
+	map<String, Entry> m_entries;
+	FileOutputStream m_outputStream;
+	TextWriter* m_writer;
+};
+
+#endif // RESULT_CACHE_H
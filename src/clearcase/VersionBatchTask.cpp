@@ -0,0 +1,185 @@
+// VersionBatchTask.cpp
+
+#include "VersionBatchTask.h"
+
+#include <algorithm>
+#include <map>
+using namespace std;
+
+VersionBatchTask::VersionBatchTask(CleartoolSessionPool* sessionPool,
+								   uint32 describeLimit)
+{
+	m_sessionPool = sessionPool;
+	m_describeLimit = describeLimit;
+}
+
+VersionBatchTask::~VersionBatchTask()
+{
+	for (uint32 i = 0; i < m_tasks.size(); i++)
+	{
+		delete m_tasks.at(i);
+	}
+}
+
+void VersionBatchTask::add(AnalyzeTask* analyzeTask)
+{
+	m_tasks.push_back(analyzeTask);
+}
+
+uint32 VersionBatchTask::size()
+{
+	return m_tasks.size();
+}
+
+void VersionBatchTask::run()
+{
+	describeAll();
+
+	// Keep each element's versions together and in order
+	stable_sort(m_tasks.begin(), m_tasks.end(), isEarlierVersion);
+
+	// Fan the described versions back out to their analysis
+	for (uint32 i = 0; i < m_tasks.size(); i++)
+	{
+		m_tasks.at(i)->run();
+	}
+}
+
+// Private functions --------------------------------------------------------
+
+void VersionBatchTask::describeAll()
+{
+	vector<AnalyzeTask*> toDescribe;
+
+	for (uint32 i = 0; i < m_tasks.size(); i++)
+	{
+		AnalyzeTask* analyzeTask = m_tasks.at(i);
+
+		if (analyzeTask->hasDescriptionRecord() || analyzeTask->isCached())
+		{
+			continue;
+		}
+
+		toDescribe.push_back(analyzeTask);
+
+		if (toDescribe.size() >= m_describeLimit)
+		{
+			describe(toDescribe);
+			toDescribe.clear();
+		}
+	}
+
+	if (toDescribe.size() > 0)
+	{
+		describe(toDescribe);
+	}
+}
+
+void VersionBatchTask::describe(vector<AnalyzeTask*>& tasks)
+{
+	String command("describe -fmt \"");
+	command.append(DESCRIPTION_FORMAT);
+	command.append('\"');
+
+	for (uint32 i = 0; i < tasks.size(); i++)
+	{
+		command.append(" \"");
+		command.append(tasks.at(i)->getVersionName());
+		command.append('\"');
+	}
+
+	String result;
+
+	{
+		PooledSession session(m_sessionPool);
+		session->execute(command, result);
+	}
+
+	// Split the output into records, matched up with the tasks by version
+	// name. Errors for individual versions show up as lines that are not
+	// records, which leaves those tasks to describe their version alone and
+	// report the problem. The names are looked up in place in the result.
+	map<StringView, uint32> records;
+	vector<String> orderedRecords;
+	uint32 lineStart = 0;
+
+	while (lineStart < result.length())
+	{
+		int32 lineEnd = result.indexOf('\n', lineStart);
+
+		if (lineEnd < 0)
+		{
+			lineEnd = result.length();
+		}
+
+		StringView line(result.c_str() + lineStart, lineEnd - lineStart);
+		int32 nameEnd = line.indexOf('\t');
+
+		if (nameEnd > 0)
+		{
+			records[line.subView(0, nameEnd)] = orderedRecords.size();
+			orderedRecords.push_back(line.toString());
+		}
+
+		lineStart = lineEnd + 1;
+	}
+
+	// cleartool may print the names differently than they were passed in.
+	// The records come back in argument order, so if there is one for every
+	// version they can still be matched by position.
+	bool matchByPosition = (orderedRecords.size() == tasks.size());
+
+	for (uint32 i = 0; i < tasks.size(); i++)
+	{
+		AnalyzeTask* analyzeTask = tasks.at(i);
+		map<StringView, uint32>::iterator iter =
+			records.find(StringView(analyzeTask->getVersionName()));
+
+		if (iter != records.end())
+		{
+			analyzeTask->setDescriptionRecord(orderedRecords.at(iter->second));
+		}
+		else if (matchByPosition)
+		{
+			analyzeTask->setDescriptionRecord(orderedRecords.at(i));
+		}
+	}
+}
+
+bool VersionBatchTask::isEarlierVersion(AnalyzeTask* first, AnalyzeTask* second)
+{
+	// Everything up to the version number is the element and branch,
+	// as in /vobs/sw/file.c@@/main/br/3 or \sw\file.c@@\main\br\3
+	// Called O(n log n) times per batch, so the names are only looked at
+	// in place
+	StringView firstName(first->getVersionName());
+	StringView secondName(second->getVersionName());
+	int32 firstSlash = max<int32>(firstName.lastIndexOf('/'), firstName.lastIndexOf('\\'));
+	int32 secondSlash = max<int32>(secondName.lastIndexOf('/'), secondName.lastIndexOf('\\'));
+
+	StringView firstBranch = firstName.subView(0, firstSlash + 1);
+	StringView secondBranch = secondName.subView(0, secondSlash + 1);
+
+	if (!firstBranch.equals(secondBranch))
+	{
+		return firstBranch < secondBranch;
+	}
+
+	return getVersionNumber(firstName.subView(firstSlash + 1, firstName.length())) <
+		getVersionNumber(secondName.subView(secondSlash + 1, secondName.length()));
+}
+
+uint64 VersionBatchTask::getVersionNumber(const StringView& number)
+{
+	// Anything that isn't all digits, like CHECKEDOUT, sorts first
+	const char* end = number.data() + number.length();
+	uint64 value;
+
+	if (String::parseNumber(number.data(), end, value) != number.length() ||
+		number.length() == 0)
+	{
+		return 0;
+	}
+
+	return value;
+}
@@ -0,0 +1,64 @@
+// VersionBatchTask.h
+
+#ifndef VERSION_BATCH_TASK_H
+#define VERSION_BATCH_TASK_H
+
+#include <ccsponge.h>
+#include <clearcase/AnalyzeTask.h>
+#include <clearcase/CleartoolSessionPool.h>
+#include <text/StringView.h>
+#include <util/Runnable.h>
+
+#include <vector>
+using namespace std;
+
+/*
+ * Runnable that describes a batch of versions with a single
+ * "cleartool describe -fmt" command and then runs the AnalyzeTask for each
+ * of them. Spreads the cost of a cleartool command and its VOB round trips
+ * over many versions. Versions that already have a description record or a
+ * cached result are not described.
+ *
+ * The tasks are run sorted by element, branch and version number, so each
+ * version of an element is compared right after its predecessor.
+ *
+ * The AnalyzeTasks are run in the calling thread rather than being passed
+ * back to the ThreadPool, as a batch waiting on a full queue could
+ * otherwise deadlock the pool.
+ */
+class VersionBatchTask : public Runnable
+{
+public:
+	/*
+	 * Creates a batch that describes at most describeLimit versions with
+	 * each "cleartool describe" command.
+	 */
+	VersionBatchTask(CleartoolSessionPool* sessionPool, uint32 describeLimit);
+	~VersionBatchTask();
+
+	/*
+	 * Adds a task to the batch. The AnalyzeTask must be allocated with new
+	 * and will be deleted by the batch.
+	 */
+	void add(AnalyzeTask* analyzeTask);
+
+	uint32 size();
+
+	void run();
+
+private:
+	VersionBatchTask(const VersionBatchTask& other) {}
+	VersionBatchTask& operator=(const VersionBatchTask& other) {}
+
+	void describeAll();
+	void describe(vector<AnalyzeTask*>& tasks);
+	static bool isEarlierVersion(AnalyzeTask* first, AnalyzeTask* second);
+	static uint64 getVersionNumber(const StringView& number);
+
+private:
+	CleartoolSessionPool* m_sessionPool;
+	uint32 m_describeLimit;
+	vector<AnalyzeTask*> m_tasks;
+};
+
+#endif // VERSION_BATCH_TASK_H
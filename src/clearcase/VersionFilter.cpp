@@ -0,0 +1,241 @@
+// VersionFilter.cpp
+
+#include "VersionFilter.h"
+#include <clearcase/VersionName.h>
+
+
+VersionFilter::VersionFilter()
+{
+
+}
+
+VersionFilter::~VersionFilter()
+{
+
+}
+
+void VersionFilter::compile(const vector<String>& extensions,
+							const vector<String>& includes,
+							const vector<String>& excludes)
+{
+	m_suffixes.clear();
+
+	if (extensions.size() > 0)
+	{
+		SuffixNode root;
+		root.c = '\0';
+		root.isEnd = false;
+		root.firstChild = 0;
+		root.nextSibling = 0;
+		m_suffixes.push_back(root);
+
+		for (uint32 i = 0; i < extensions.size(); i++)
+		{
+			addExtension(extensions[i]);
+		}
+	}
+
+	compileGlobs(includes, m_includes);
+	compileGlobs(excludes, m_excludes);
+
+	// find's -name takes a single file name pattern, so only a lone
+	// extension or a lone file name include can be handed to it
+	m_findNamePattern = String();
+
+	if (extensions.size() == 1 && m_includes.size() == 0)
+	{
+		m_findNamePattern = String("*") + extensions[0];
+	}
+	else if (extensions.size() == 0 && m_includes.size() == 1 &&
+			 !m_includes[0].matchesPath)
+	{
+		m_findNamePattern = m_includes[0].pattern;
+	}
+}
+
+bool VersionFilter::passes(const StringView& versionName) const
+{
+	// Checked out versions have no number, and zero versions are the same
+	// as the version they were branched from
+	VersionName name;
+
+	if (!name.parse(versionName) || name.getNumber() == 0)
+	{
+		return false;
+	}
+
+	StringView element = name.getElement();
+
+	if (m_suffixes.size() > 0 && !matchesExtension(element))
+	{
+		return false;
+	}
+
+	if (m_includes.size() == 0 && m_excludes.size() == 0)
+	{
+		return true;
+	}
+
+	int32 slashIndex = element.lastIndexOf('/');
+	int32 backslashIndex = element.lastIndexOf('\\');
+	int32 fileNameStart = ((slashIndex > backslashIndex) ? slashIndex : backslashIndex) + 1;
+	StringView fileName = element.subView(fileNameStart, element.length());
+
+	if (m_includes.size() > 0 && !matchesAny(m_includes, element, fileName))
+	{
+		return false;
+	}
+
+	return !matchesAny(m_excludes, element, fileName);
+}
+
+String VersionFilter::getFindNamePattern() const
+{
+	return m_findNamePattern;
+}
+
+// Private functions --------------------------------------------------------
+
+void VersionFilter::addExtension(const String& extension)
+{
+	uint32 node = 0;
+
+	for (uint32 i = extension.length(); i > 0; i--)
+	{
+		char c = extension.charAt(i - 1);
+		uint32 child = m_suffixes[node].firstChild;
+
+		while (child != 0 && m_suffixes[child].c != c)
+		{
+			child = m_suffixes[child].nextSibling;
+		}
+
+		if (child == 0)
+		{
+			SuffixNode newNode;
+			newNode.c = c;
+			newNode.isEnd = false;
+			newNode.firstChild = 0;
+			newNode.nextSibling = m_suffixes[node].firstChild;
+
+			child = m_suffixes.size();
+			m_suffixes.push_back(newNode);
+			m_suffixes[node].firstChild = child;
+		}
+
+		node = child;
+	}
+
+	m_suffixes[node].isEnd = true;
+}
+
+bool VersionFilter::matchesExtension(const StringView& element) const
+{
+	// Walk back from the end of the name until an extension ends or no
+	// extension has the next character
+	uint32 node = 0;
+	uint32 index = element.length();
+
+	while (!m_suffixes[node].isEnd)
+	{
+		if (index == 0)
+		{
+			return false;
+		}
+
+		char c = element.charAt(--index);
+		uint32 child = m_suffixes[node].firstChild;
+
+		while (child != 0 && m_suffixes[child].c != c)
+		{
+			child = m_suffixes[child].nextSibling;
+		}
+
+		if (child == 0)
+		{
+			return false;
+		}
+
+		node = child;
+	}
+
+	return true;
+}
+
+void VersionFilter::compileGlobs(const vector<String>& patterns, vector<Glob>& globs)
+{
+	globs.clear();
+
+	for (uint32 i = 0; i < patterns.size(); i++)
+	{
+		int32 slashIndex = patterns[i].indexOf('/');
+		int32 backslashIndex = patterns[i].indexOf('\\');
+
+		Glob glob;
+		glob.pattern = patterns[i];
+		glob.matchesPath = (slashIndex >= 0 || backslashIndex >= 0);
+		globs.push_back(glob);
+	}
+}
+
+bool VersionFilter::matchesAny(const vector<Glob>& globs,
+							   const StringView& element,
+							   const StringView& fileName)
+{
+	for (uint32 i = 0; i < globs.size(); i++)
+	{
+		if (matchesGlob(globs[i].pattern, globs[i].matchesPath ? element : fileName))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool VersionFilter::matchesGlob(const StringView& pattern, const StringView& text)
+{
+	// Match greedily, and on a mismatch let the last '*' take one more
+	// character. Only the last '*' ever needs to be retried.
+	uint32 patternIndex = 0;
+	uint32 textIndex = 0;
+	int32 starIndex = -1;
+	uint32 starTextIndex = 0;
+
+	while (textIndex < text.length())
+	{
+		char p = (patternIndex < pattern.length()) ? pattern.charAt(patternIndex) : '\0';
+		char t = text.charAt(textIndex);
+
+		// Either separator in a pattern matches either in a name
+		bool isMatch = (p == t || p == '?' ||
+						((p == '/' || p == '\\') && (t == '/' || t == '\\')));
+
+		if (patternIndex < pattern.length() && p == '*')
+		{
+			starIndex = patternIndex++;
+			starTextIndex = textIndex;
+		}
+		else if (patternIndex < pattern.length() && isMatch)
+		{
+			patternIndex++;
+			textIndex++;
+		}
+		else if (starIndex >= 0)
+		{
+			patternIndex = starIndex + 1;
+			textIndex = ++starTextIndex;
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	while (patternIndex < pattern.length() && pattern.charAt(patternIndex) == '*')
+	{
+		patternIndex++;
+	}
+
+	return (patternIndex == pattern.length());
+}
@@ -0,0 +1,84 @@
+// VersionFilter.h
+
+#ifndef VERSION_FILTER_H
+#define VERSION_FILTER_H
+
+#include <ccsponge.h>
+#include <text/String.h>
+#include <text/StringView.h>
+
+#include <vector>
+using namespace std;
+
+/*
+ * The filters on version names given by -exts, -include and -exclude,
+ * compiled once so each version is checked without any copying. Zero
+ * versions, CHECKEDOUT versions and names without "@@" never pass.
+ *
+ * The extensions are held in a trie of their characters in reverse, so the
+ * end of the element name is walked back over once however many
+ * extensions there are.
+ *
+ * -include and -exclude take globs where '*' matches any run of
+ * characters and '?' any one character. A glob with a '/' or '\' in it is
+ * matched against the element's whole path, otherwise only against its
+ * file name. A version passes if its element matches one of the includes,
+ * if there are any, and none of the excludes.
+ *
+ * Safe for access by multiple threads once compiled.
+ */
+class VersionFilter
+{
+public:
+	VersionFilter();
+	~VersionFilter();
+
+	/*
+	 * Replaces the filters. Extensions are like ".cpp". No extensions or
+	 * no includes means any are allowed.
+	 */
+	void compile(const vector<String>& extensions,
+				 const vector<String>& includes,
+				 const vector<String>& excludes);
+
+	bool passes(const StringView& versionName) const;
+
+	/*
+	 * Returns a file name pattern for the -name option of
+	 * "cleartool find" that keeps at least everything passes() would
+	 * accept, or an empty String if the filters can't be narrowed to one.
+	 * find then leaves out the other elements' versions entirely.
+	 */
+	String getFindNamePattern() const;
+
+private:
+	struct SuffixNode
+	{
+		char c;
+		bool isEnd; // An extension ends here
+		uint32 firstChild; // 0 if none, as the root is never a child
+		uint32 nextSibling; // 0 if none
+	};
+
+	struct Glob
+	{
+		String pattern;
+		bool matchesPath; // Against the whole element path, not the file name
+	};
+
+	void addExtension(const String& extension);
+	bool matchesExtension(const StringView& element) const;
+	static void compileGlobs(const vector<String>& patterns, vector<Glob>& globs);
+	static bool matchesAny(const vector<Glob>& globs,
+						   const StringView& element,
+						   const StringView& fileName);
+	static bool matchesGlob(const StringView& pattern, const StringView& text);
+
+private:
+	vector<SuffixNode> m_suffixes; // Empty if there is no -exts filter
+	vector<Glob> m_includes;
+	vector<Glob> m_excludes;
+	String m_findNamePattern;
+};
+
+#endif // VERSION_FILTER_H
@@ -0,0 +1,81 @@
+// VersionName.cpp
+
+#include "VersionName.h"
+
+
+VersionName::VersionName()
+{
+	m_separator = '/';
+	m_number = 0;
+}
+
+VersionName::~VersionName()
+{
+
+}
+
+bool VersionName::parse(const StringView& versionName)
+{
+	int32 atatIndex = versionName.indexOf("@@");
+
+	if (atatIndex < 0)
+	{
+		return false;
+	}
+
+	// The version number follows the last separator
+	int32 slashIndex = versionName.lastIndexOf('/');
+	int32 backslashIndex = versionName.lastIndexOf('\\');
+	int32 numberStart = ((slashIndex > backslashIndex) ? slashIndex : backslashIndex) + 1;
+
+	if (numberStart <= atatIndex + 3)
+	{
+		return false;
+	}
+
+	uint32 numberLength = versionName.length() - numberStart;
+	uint64 number;
+
+	if (String::parseNumber(versionName.data() + numberStart,
+			versionName.data() + versionName.length(), number) != numberLength ||
+		number > 0xFFFFFFFF)
+	{
+		return false;
+	}
+
+	m_element = versionName.subView(0, atatIndex);
+	m_branch = versionName.subView(atatIndex + 2, numberStart - 1);
+	m_separator = versionName.charAt(numberStart - 1);
+	m_number = (uint32)number;
+	return true;
+}
+
+StringView VersionName::getElement() const
+{
+	return m_element;
+}
+
+StringView VersionName::getBranch() const
+{
+	return m_branch;
+}
+
+uint32 VersionName::getNumber() const
+{
+	return m_number;
+}
+
+bool VersionName::getPredecessor(String& predecessorName) const
+{
+	if (m_number == 0)
+	{
+		return false;
+	}
+
+	predecessorName.assign(m_element.data(), m_element.length());
+	predecessorName.append("@@");
+	predecessorName.append(m_branch.data(), m_branch.length());
+	predecessorName.append(m_separator);
+	predecessorName.append(m_number - 1);
+	return true;
+}
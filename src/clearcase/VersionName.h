@@ -0,0 +1,58 @@
+// VersionName.h
+
+#ifndef VERSION_NAME_H
+#define VERSION_NAME_H
+
+#include <ccsponge.h>
+#include <text/String.h>
+#include <text/StringView.h>
+
+/*
+ * Splits a version extended name like /vobs/sw/file.c@@/main/br/17 into
+ * the element "/vobs/sw/file.c", the branch "/main/br" and the version
+ * number 17. Branches may be separated by '/' or '\'.
+ *
+ * Every version but a zero version has the version before it on the same
+ * branch as its predecessor, so the predecessor can be worked out from the
+ * name without asking the VOB.
+ *
+ * The parts are views of the name passed to parse(), so are only valid
+ * while that name is.
+ */
+class VersionName
+{
+public:
+	VersionName();
+	~VersionName();
+
+	/*
+	 * Splits up the name. Returns false if it has no "@@" or doesn't end
+	 * in a version number, as with CHECKEDOUT.
+	 */
+	bool parse(const StringView& versionName);
+
+	StringView getElement() const;
+
+	/*
+	 * Returns the branch path, from the separator after the "@@" up to but
+	 * not including the separator before the version number.
+	 */
+	StringView getBranch() const;
+
+	uint32 getNumber() const;
+
+	/*
+	 * Sets predecessorName to the extended name of the version before this
+	 * one on the same branch. Returns false for a zero version, whose
+	 * predecessor is on the parent branch and has to be looked up.
+	 */
+	bool getPredecessor(String& predecessorName) const;
+
+private:
+	StringView m_element;
+	StringView m_branch;
+	char m_separator; // The separator before the version number
+	uint32 m_number;
+};
+
+#endif // VERSION_NAME_H
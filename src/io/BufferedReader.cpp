@@ -0,0 +1,133 @@
+// BufferedReader.cpp
+
+#include "BufferedReader.h"
+
+#include <string.h> // For memchr(), memcpy() and memmove()
+
+// How much to read from the stream at a time
+#define INITIAL_BUFFER_SIZE 65536
+
+
+BufferedReader::BufferedReader(InputStream* inputStream)
+{
+	m_inputStream = inputStream;
+	m_bufferSize = INITIAL_BUFFER_SIZE;
+	m_buffer = new char[m_bufferSize];
+	m_start = 0;
+	m_end = 0;
+	m_endOfStream = false;
+}
+
+BufferedReader::~BufferedReader()
+{
+	delete[] m_buffer;
+}
+
+bool BufferedReader::hasBufferedData()
+{
+	return (m_start < m_end);
+}
+
+bool BufferedReader::readLine(const char*& line, uint32& length)
+{
+	// Only the part of the buffer not searched yet needs searching after
+	// a fill
+	uint32 searchStart = m_start;
+
+	while (true)
+	{
+		char* newline = (char*)memchr(m_buffer + searchStart, '\n',
+			m_end - searchStart);
+
+		if (newline != NULL)
+		{
+			line = m_buffer + m_start;
+			length = (uint32)(newline - line);
+			m_start += length + 1;
+
+			// Eat a carriage return before the newline
+			if (length > 0 && line[length - 1] == '\r')
+			{
+				length--;
+			}
+
+			return true;
+		}
+
+		uint32 searched = m_end - m_start;
+
+		if (!fill())
+		{
+			break;
+		}
+
+		searchStart = m_start + searched;
+	}
+
+	// The last line wasn't ended by a newline
+	if (m_start == m_end)
+	{
+		return false;
+	}
+
+	line = m_buffer + m_start;
+	length = m_end - m_start;
+	m_start = m_end;
+	return true;
+}
+
+String BufferedReader::readLine(bool& success)
+{
+	const char* line;
+	uint32 length;
+	String ret;
+
+	success = readLine(line, length);
+
+	if (success)
+	{
+		ret.append(line, length);
+	}
+
+	return ret;
+}
+
+// Private functions --------------------------------------------------------
+
+bool BufferedReader::fill()
+{
+	if (m_endOfStream)
+	{
+		return false;
+	}
+
+	// Move the unreturned part to the front to make room after it
+	if (m_start > 0)
+	{
+		memmove(m_buffer, m_buffer + m_start, m_end - m_start);
+		m_end -= m_start;
+		m_start = 0;
+	}
+
+	// A line longer than the buffer needs a bigger buffer
+	if (m_end == m_bufferSize)
+	{
+		char* newBuffer = new char[m_bufferSize * 2];
+		memcpy(newBuffer, m_buffer, m_end);
+		delete[] m_buffer;
+		m_buffer = newBuffer;
+		m_bufferSize *= 2;
+	}
+
+	int64 bytesRead = m_inputStream->read(m_buffer + m_end,
+		m_bufferSize - m_end);
+
+	if (bytesRead < 0)
+	{
+		m_endOfStream = true;
+		return false;
+	}
+
+	m_end += (uint32)bytesRead;
+	return true;
+}
@@ -0,0 +1,58 @@
+// BufferedReader.h
+
+#ifndef BUFFERED_READER_H
+#define BUFFERED_READER_H
+
+#include <ccsponge.h>
+#include <io/InputStream.h>
+#include <text/String.h>
+
+/*
+ * Reads lines of text from an InputStream a large block at a time, instead
+ * of the single bytes TextReader reads. Lines can be had as a pointer into
+ * the buffer, so reading them copies nothing.
+ *
+ * A line ends at "\n" or "\r\n", which is left out of the line. A "\r"
+ * anywhere else is kept. The buffer grows to fit a line longer than it.
+ *
+ * Not safe for access by multiple threads.
+ */
+class BufferedReader
+{
+public:
+	BufferedReader(InputStream* inputStream);
+	~BufferedReader();
+
+	/*
+	 * Points line at the next line and sets length to its length. The
+	 * line is only valid until the next call. Returns false at the end of
+	 * the stream.
+	 */
+	bool readLine(const char*& line, uint32& length);
+
+	/*
+	 * Same as above, but copies the line into a String.
+	 */
+	String readLine(bool& success);
+
+	/*
+	 * Returns true if bytes have been read from the stream that haven't
+	 * been returned as part of a line yet.
+	 */
+	bool hasBufferedData();
+
+private:
+	BufferedReader(const BufferedReader& other) {}
+	BufferedReader& operator=(const BufferedReader& other) {}
+
+	bool fill();
+
+	InputStream* m_inputStream;
+	char* m_buffer;
+	uint32 m_bufferSize;
+	uint32 m_start; // First byte not yet returned
+	uint32 m_end; // One past the last byte read into the buffer
+	bool m_endOfStream;
+};
+
+#endif // BUFFERED_READER_H
@@ -0,0 +1,31 @@
+// StringOutputStream.cpp
+
+#include "StringOutputStream.h"
+
+
+StringOutputStream::StringOutputStream(String* target)
+{
+	m_target = target;
+}
+
+StringOutputStream::~StringOutputStream()
+{
+
+}
+
+void StringOutputStream::close()
+{
+
+}
+
+int32 StringOutputStream::write(int32 byte)
+{
+	m_target->append((char)(byte & 0x000000ff));
+	return 1;
+}
+
+int64 StringOutputStream::write(const void* buffer, uint32 maxlen)
+{
+	m_target->append((const char*)buffer, maxlen);
+	return maxlen;
+}
@@ -0,0 +1,31 @@
+// StringOutputStream.h
+
+#ifndef STRING_OUTPUT_STREAM_H
+#define STRING_OUTPUT_STREAM_H
+
+#include <ccsponge.h>
+#include <io/OutputStream.h>
+#include <text/String.h>
+
+/*
+ * An OutputStream that appends everything written to it to a String. The
+ * String is owned by the caller and must outlive the stream.
+ */
+class StringOutputStream : public OutputStream
+{
+public:
+	StringOutputStream(String* target);
+	~StringOutputStream();
+
+	void close();
+	int32 write(int32 byte);
+	int64 write(const void* buffer, uint32 maxlen);
+
+private:
+	StringOutputStream(const StringOutputStream& other) {}
+	StringOutputStream& operator=(const StringOutputStream& other) {}
+
+	String* m_target;
+};
+
+#endif // STRING_OUTPUT_STREAM_H
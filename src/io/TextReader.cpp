@@ -2,6 +2,12 @@
 
 #include "TextReader.h"
 
+#include <string.h> // For memchr()
+
+// The first read is small so short texts don't waste memory, and each one
+// after is twice as big up to the largest
+#define FIRST_READ_SIZE 4096
+#define MAX_READ_SIZE (1024 * 1024)
 
 TextReader::TextReader(InputStream* inputStream)
 {
@@ -55,21 +61,58 @@ String TextReader::readLine(bool& success)
 
 String TextReader::readAll()
 {
-	char buffer[1024];
-	int64 bytesRead = 1;
 	String ret;
+	uint32 length = 0;
+	uint32 readSize = FIRST_READ_SIZE;
 
 	while (true)
 	{
-		bytesRead = m_inputStream->read(buffer, 1023);
+		// Read straight into the end of the String instead of a buffer
+		char* block = ret.extend(readSize);
+		int64 bytesRead = m_inputStream->read(block, readSize);
 
 		if (bytesRead < 0)
 			break;
 
-		buffer[bytesRead] = '\0';
-		ret.append(buffer);
+		// A \r at the end of the last block may pair with a \n at the
+		// start of this one, so that case can't take the fast path
+		bool pending = length > 0 && block[-1] == '\r';
+
+		if (!pending && memchr(block, '\r', (size_t)bytesRead) == NULL)
+		{
+			length += (uint32)bytesRead;
+		}
+		else
+		{
+			// Turn each \r\n into \n, moving the rest of the block down over
+			// the \r characters taken out
+			const char* start = block - length;
+			char* out = block;
+			char* end = block + bytesRead;
+
+			for (const char* in = block; in < end; in++)
+			{
+				if (*in == '\n' && out > start && out[-1] == '\r')
+				{
+					out[-1] = '\n';
+				}
+				else
+				{
+					*out++ = *in;
+				}
+			}
+
+			length += (uint32)(out - block);
+		}
+
+		ret.setLength(length);
+
+		if (readSize < MAX_READ_SIZE)
+		{
+			readSize *= 2;
+		}
 	}
 
-	ret.replaceAll("\r\n", "\n");
+	ret.setLength(length);
 	return ret;
 }
@@ -3,21 +3,98 @@
 #include <ccsponge.h>
 #include <Help.h>
 #include <Settings.h>
+#include <clearcase/CleartoolSessionPool.h>
+#include <clearcase/ContentCache.h>
 #include <clearcase/CtFindTask.h>
+#include <clearcase/LsHistoryTask.h>
+#include <clearcase/ProgressJournal.h>
+#include <clearcase/ResultCache.h>
 #include <exception/IOException.h>
 #include <exception/ParsingException.h>
 #include <exception/SystemException.h>
-#include <io/InputStream.h>
+#include <io/FileInputStream.h>
 #include <io/FileOutputStream.h>
+#include <io/InputStream.h>
 #include <thread/ThreadPool.h>
 #include <thread/Process.h>
 
 #include <iostream>
+#include <stdio.h> // For remove() and rename()
 using namespace std;
 
+#ifdef UNIX
+#	include <signal.h> // For signal()
+#endif
+
+
+/*
+ * Restores the state saved by the last -incremental run into the data
+ * store. A missing file means this is the first run. Returns false if the
+ * state can't be used.
+ */
+bool readIncrementalState(const String& fileName, DataStore& dataStore)
+{
+	FileInputStream inStream;
+
+	try
+	{
+		inStream.open(fileName);
+	}
+	catch (IOException&)
+	{
+		cout << "No incremental state in " << fileName.c_str()
+			<< ", analyzing all versions" << endl;
+		return true;
+	}
+
+	try
+	{
+		dataStore.readState(inStream);
+	}
+	catch (ParsingException& e)
+	{
+		cerr << "Failed to read incremental state from " << fileName.c_str()
+			<< ": " << e.what() << endl;
+		return false;
+	}
+
+	inStream.close();
+	return true;
+}
+
+/*
+ * Saves the data store for the next -incremental run. The state is written
+ * next to the old one first, so a failed write leaves the old state intact.
+ */
+void writeIncrementalState(const String& fileName, DataStore& dataStore)
+{
+	String tempFileName = fileName + ".tmp";
+
+	FileOutputStream outStream;
+	outStream.open(tempFileName);
+	dataStore.writeState(outStream);
+	outStream.close();
+
+#ifdef WINDOWS
+	// rename() won't replace an existing file on Windows
+	remove(fileName.c_str());
+#endif
+
+	if (rename(tempFileName.c_str(), fileName.c_str()) != 0)
+	{
+		throw IOException(String("Failed to replace incremental state ")
+			+ fileName);
+	}
+}
 
 int main(int argc, char* argv[])
 {
+	// A cleartool session that dies would otherwise kill us with SIGPIPE
+	// the next time we write a command to it
+#ifdef UNIX
+	signal(SIGPIPE, SIG_IGN);
+#endif
+
 	try
 	{
 		// Make the arguments into an Array of String
@@ -73,15 +150,81 @@ int main(int argc, char* argv[])
 		// Make the DataStore object to hold the result
 		DataStore dataStore(&settings);
 
+		// Pick up the totals of the last -incremental run
+		String stateFileName = settings.getStateFile();
+
+		if (stateFileName.length() > 0 &&
+			!readIncrementalState(stateFileName, dataStore))
+		{
+			return 1;
+		}
+
+		// Record each version counted, so a run that dies can be picked
+		// up again with -resume
+		String journalFileName = outputFileName + ".journal";
+		ProgressJournal journal;
+		journal.open(journalFileName, settings.getResume());
+		journal.replay(dataStore);
+
+		// Make the pool of interactive cleartool processes used by the
+		// workers. Must outlive the thread pool.
+		CleartoolSessionPool sessionPool;
+
+		// Version text kept between -localdiff comparisons
+		ContentCache contentCache(settings.getCacheSize() * 1024 * 1024);
+
+		// Results of earlier runs, if the user asked to keep them
+		ResultCache resultCache;
+
+		if (settings.getCacheFile().length() > 0)
+		{
+			// Only results counted the same way as this run can be reused
+			ResultCache::DiffMode diffMode = ResultCache::CLEARTOOL_DIFF;
+
+			if (settings.getLocalDiff())
+			{
+				diffMode = ResultCache::LOCAL_DIFF;
+			}
+			else if (settings.getHeadersOnly())
+			{
+				diffMode = ResultCache::HEADERS_ONLY;
+			}
+
+			resultCache.open(settings.getCacheFile(), diffMode);
+		}
+
 		// Make our thread pool
 		// 4 thread max
 		// Threads stop if idle for half a second
 		// Max queue size of 200 items
 		ThreadPool threadPool(4, 500, 200);
 
-		// Put the first task in the thread pool
-		CtFindTask* ctFindTask = new CtFindTask(&threadPool, &dataStore, &settings);
-		threadPool.execute(ctFindTask);
+		// Put the first task in the thread pool. It finds the versions and
+		// queues up the rest of the work.
+		Runnable* sourceTask;
+
+		if (settings.getUseHistory())
+		{
+			sourceTask = new LsHistoryTask(&threadPool,
+				&dataStore,
+				&settings,
+				&sessionPool,
+				&contentCache,
+				&resultCache,
+				&journal);
+		}
+		else
+		{
+			sourceTask = new CtFindTask(&threadPool,
+				&dataStore,
+				&settings,
+				&sessionPool,
+				&contentCache,
+				&resultCache,
+				&journal);
+		}
+
+		threadPool.execute(sourceTask);
 
 		// This will block until all every runnable in the thread pool has completed
 		threadPool.shutdownWhenEmpty();
@@ -90,6 +233,28 @@ int main(int argc, char* argv[])
 		dataStore.writeToStream(outStream);
 		outStream.close();
 
+		// Write a report next to it for each -groupby dimension
+		const vector<Settings::dimension>& groupBy = settings.getGroupBy();
+
+		for (uint32 i = 0; i < groupBy.size(); i++)
+		{
+			String reportFileName = outputFileName + "." +
+				Settings::getDimensionName(groupBy[i]) + ".csv";
+			FileOutputStream reportStream;
+			reportStream.open(reportFileName);
+			dataStore.writeGroupToStream(groupBy[i], reportStream);
+			reportStream.close();
+		}
+
+		if (stateFileName.length() > 0)
+		{
+			writeIncrementalState(stateFileName, dataStore);
+		}
+
+		// The run is complete so there is nothing left to resume
+		journal.close();
+		remove(journalFileName.c_str());
+
 		return 0;
 	}
 	catch (exception& e)
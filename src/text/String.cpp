@@ -3,8 +3,10 @@
 #include "String.h"
 
 #include <algorithm>
+#include <ctype.h> // For isspace()
 #include <iostream>
-#include <sstream>
+#include <stdio.h> // For sprintf()
+#include <stdlib.h> // For strtod()
 #include <string.h>
 
 // Alias the Windows function to compare ignoring case
@@ -18,6 +20,21 @@
 #define stricmp(x, y) strcasecmp((x), (y))
 #endif
 
+// Room for the base 10 text of any 64 bit number, such as
+// -9223372036854775808
+#define NUMBER_BUFFER_SIZE 20
+
+// Room for the text of any float or double printed with %g
+#define FLOAT_BUFFER_SIZE 32
+
+// Functions shared by the number conversions
+template <typename T>
+static T toUnsigned(const std::string& str, T maxValue, bool& success);
+template <typename T>
+static T toSigned(const std::string& str, T minValue, T maxValue, bool& success);
+static double toFloatingPoint(const std::string& str, bool& success);
+static bool isSpaceTo(const char* pos, const char* end);
+
 
 String::String()
 {
@@ -29,6 +46,14 @@ String::String(const String& str)
 	m_str.assign(str.m_str);
 }
 
+#ifdef HAS_RVALUE_REFS
+String::String(String&& str) :
+	m_str(std::move(str.m_str))
+{
+
+}
+#endif
+
 String::String(const std::string& str)
 {
 	m_str.assign(str);
@@ -41,65 +66,47 @@ String::String(int8 c)
 
 String::String(int16 n)
 {
-	stringstream ss;
-	ss << n;
-	ss >> m_str;
+	append(n);
 }
 
 String::String(int32 n)
 {
-	stringstream ss;
-	ss << n;
-	ss >> m_str;
+	append(n);
 }
 
 String::String(int64 n)
 {
-	stringstream ss;
-	ss << n;
-	ss >> m_str;
+	append(n);
 }
 
 String::String(uint8 n)
 {
-	stringstream ss;
-	ss << n;
-	ss >> m_str;
+	append(n);
 }
 
 String::String(uint16 n)
 {
-	stringstream ss;
-	ss << n;
-	ss >> m_str;
+	append(n);
 }
 
 String::String(uint32 n)
 {
-	stringstream ss;
-	ss << n;
-	ss >> m_str;
+	append(n);
 }
 
 String::String(uint64 n)
 {
-	stringstream ss;
-	ss << n;
-	ss >> m_str;
+	append(n);
 }
 
 String::String(float n)
 {
-	stringstream ss;
-	ss << n;
-	ss >> m_str;
+	append(n);
 }
 
 String::String(double n)
 {
-	stringstream ss;
-	ss << n;
-	ss >> m_str;
+	append(n);
 }
 
 String::String(const char* str)
@@ -119,37 +126,57 @@ void String::append(int8 c)
 
 void String::append(int16 value)
 {
-	append(String(value));
+	char buffer[NUMBER_BUFFER_SIZE];
+	m_str.append(buffer, formatNumber((int64)value, buffer));
 }
 
 void String::append(int32 value)
 {
-	append(String(value));
+	char buffer[NUMBER_BUFFER_SIZE];
+	m_str.append(buffer, formatNumber((int64)value, buffer));
 }
 
 void String::append(int64 value)
 {
-	append(String(value));
+	char buffer[NUMBER_BUFFER_SIZE];
+	m_str.append(buffer, formatNumber((int64)value, buffer));
 }
 
 void String::append(uint8 value)
 {
-	append(String(value));
+	char buffer[NUMBER_BUFFER_SIZE];
+	m_str.append(buffer, formatNumber((uint64)value, buffer));
 }
 
 void String::append(uint16 value)
 {
-	append(String(value));
+	char buffer[NUMBER_BUFFER_SIZE];
+	m_str.append(buffer, formatNumber((uint64)value, buffer));
 }
 
 void String::append(uint32 value)
 {
-	append(String(value));
+	char buffer[NUMBER_BUFFER_SIZE];
+	m_str.append(buffer, formatNumber((uint64)value, buffer));
 }
 
 void String::append(uint64 value)
 {
-	append(String(value));
+	char buffer[NUMBER_BUFFER_SIZE];
+	m_str.append(buffer, formatNumber((uint64)value, buffer));
+}
+
+void String::append(float value)
+{
+	append((double)value);
+}
+
+void String::append(double value)
+{
+	// The same text a stream gives with its default precision of 6
+	char buffer[FLOAT_BUFFER_SIZE];
+	int length = sprintf(buffer, "%g", value);
+	m_str.append(buffer, length);
 }
 
 void String::append(const char* str)
@@ -157,6 +184,11 @@ void String::append(const char* str)
 	m_str.append(str);
 }
 
+void String::append(const char* data, uint32 length)
+{
+	m_str.append(data, length);
+}
+
 void String::append(const String& str)
 {
 	m_str.append(str.m_str);
@@ -167,6 +199,11 @@ void String::assign(const String& str)
 	m_str.assign(str.m_str);
 }
 
+void String::assign(const char* data, uint32 length)
+{
+	m_str.assign(data, length);
+}
+
 const char* String::c_str() const
 {
 	return m_str.c_str();
@@ -182,6 +219,21 @@ void String::clear()
 	m_str.clear();
 }
 
+char* String::extend(uint32 count)
+{
+	std::string::size_type oldLength = m_str.length();
+	std::string::size_type newLength = oldLength + count;
+
+	// Don't rely on resize() to grow the capacity geometrically
+	if (newLength > m_str.capacity())
+	{
+		m_str.reserve(std::max(newLength, m_str.capacity() * 2));
+	}
+
+	m_str.resize(newLength);
+	return &m_str[oldLength];
+}
+
 int32 String::compareTo(const String& str) const
 {
 	return m_str.compare(str.m_str);
@@ -260,6 +312,16 @@ uint32 String::length() const
 	return (uint32)m_str.length();
 }
 
+void String::swap(String& other)
+{
+	m_str.swap(other.m_str);
+}
+
+void String::setLength(uint32 length)
+{
+	m_str.resize(length);
+}
+
 void String::remove(uint32 index, uint32 count)
 {
 	m_str.erase(index, count);
@@ -328,112 +390,128 @@ void String::trim()
 
 int8 String::toInt8(bool& success) const
 {
-	stringstream ss;
-	int8 ret;
-
-	ss << m_str;
-	ss >> ret;
-	success = !ss.bad();
-	return ret;
+	return toSigned<int8>(m_str, -128, 127, success);
 }
 
 int16 String::toInt16(bool& success) const
 {
-	stringstream ss;
-	int16 ret;
-
-	ss << m_str;
-	ss >> ret;
-	success = !ss.bad();
-	return ret;
+	return toSigned<int16>(m_str, -32768, 32767, success);
 }
 
 int32 String::toInt32(bool& success) const
 {
-	stringstream ss;
-	int32 ret;
-
-	ss << m_str;
-	ss >> ret;
-	success = !ss.bad();
-	return ret;
+	return toSigned<int32>(m_str, (-2147483647 - 1), 2147483647, success);
 }
 
 int64 String::toInt64(bool& success) const
 {
-	stringstream ss;
-	int64 ret;
-
-	ss << m_str;
-	ss >> ret;
-	success = !ss.bad();
-	return ret;
+	return toSigned<int64>(m_str, (-9223372036854775807LL - 1), 9223372036854775807LL, success);
 }
 
 uint8 String::toUInt8(bool& success) const
 {
-	stringstream ss;
-	uint8 ret;
-
-	ss << m_str;
-	ss >> ret;
-	success = !ss.bad();
-	return ret;
+	return toUnsigned<uint8>(m_str, 255, success);
 }
 
 uint16 String::toUInt16(bool& success) const
 {
-	stringstream ss;
-	uint16 ret;
-
-	ss << m_str;
-	ss >> ret;
-	success = !ss.bad();
-	return ret;
+	return toUnsigned<uint16>(m_str, 65535, success);
 }
 
 uint32 String::toUInt32(bool& success) const
 {
-	stringstream ss;
-	uint32 ret;
-
-	ss << m_str;
-	ss >> ret;
-	success = !ss.bad();
-	return ret;
+	return toUnsigned<uint32>(m_str, 4294967295U, success);
 }
 
 uint64 String::toUInt64(bool& success) const
 {
-	stringstream ss;
-	uint64 ret;
-
-	ss << m_str;
-	ss >> ret;
-	success = !ss.bad();
-	return ret;
+	return toUnsigned<uint64>(m_str, 18446744073709551615ULL, success);
 }
 
 float String::toFloat(bool& success) const
 {
-	stringstream ss;
-	float ret;
-
-	ss << m_str;
-	ss >> ret;
-	success = !ss.bad();
-	return ret;
+	return (float)toFloatingPoint(m_str, success);
 }
 
 double String::toDouble(bool& success) const
 {
-	stringstream ss;
-	double ret;
+	return toFloatingPoint(m_str, success);
+}
 
-	ss << m_str;
-	ss >> ret;
-	success = !ss.bad();
-	return ret;
+uint32 String::formatNumber(uint64 value, char* buffer)
+{
+	// Write the digits backwards from the end of a scratch buffer
+	char digits[NUMBER_BUFFER_SIZE];
+	char* pos = digits + NUMBER_BUFFER_SIZE;
+
+	do
+	{
+		*--pos = (char)('0' + value % 10);
+		value /= 10;
+	}
+	while (value != 0);
+
+	uint32 length = (uint32)(digits + NUMBER_BUFFER_SIZE - pos);
+	memcpy(buffer, pos, length);
+	return length;
+}
+
+uint32 String::formatNumber(int64 value, char* buffer)
+{
+	if (value >= 0)
+	{
+		return formatNumber((uint64)value, buffer);
+	}
+
+	// Negate as unsigned so the smallest int64 doesn't overflow
+	buffer[0] = '-';
+	return 1 + formatNumber((uint64)0 - (uint64)value, buffer + 1);
+}
+
+uint32 String::parseNumber(const char* text, const char* end, uint64& value)
+{
+	const char* pos = text;
+	uint64 result = 0;
+
+	while (pos < end && *pos >= '0' && *pos <= '9')
+	{
+		uint32 digit = *pos - '0';
+
+		// Stop before the result wraps
+		if (result > (18446744073709551615ULL - digit) / 10)
+		{
+			return 0;
+		}
+
+		result = result * 10 + digit;
+		pos++;
+	}
+
+	if (pos == text)
+	{
+		return 0;
+	}
+
+	value = result;
+	return (uint32)(pos - text);
+}
+
+uint32 String::parseNumber(const char* text, const char* end, int64& value)
+{
+	bool negative = (text < end && *text == '-');
+	const char* digits = negative ? text + 1 : text;
+	uint64 magnitude;
+	uint32 length = parseNumber(digits, end, magnitude);
+
+	// The smallest int64 has no positive counterpart
+	if (length == 0 ||
+		magnitude > (negative ? 9223372036854775808ULL : 9223372036854775807ULL))
+	{
+		return 0;
+	}
+
+	value = negative ? (int64)((uint64)0 - magnitude) : (int64)magnitude;
+	return length + (negative ? 1 : 0);
 }
 
 // Overloaded operators -----------------------------------------------------
@@ -444,6 +522,14 @@ String& String::operator=(const String& other)
 	return *this;
 }
 
+#ifdef HAS_RVALUE_REFS
+String& String::operator=(String&& other)
+{
+	m_str = std::move(other.m_str);
+	return *this;
+}
+#endif
+
 
 String& String::operator+=(const String& other)
 {
@@ -454,70 +540,70 @@ String& String::operator+=(const String& other)
 
 String& String::operator+=(int8 other)
 {
-	this->append(String(other));
+	this->append(other);
 	return *this;
 }
 
 
 String& String::operator+=(int16 other)
 {
-	this->append(String(other));
+	this->append(other);
 	return *this;
 }
 
 
 String& String::operator+=(int32 other)
 {
-	this->append(String(other));
+	this->append(other);
 	return *this;
 }
 
 
 String& String::operator+=(int64 other)
 {
-	this->append(String(other));
+	this->append(other);
 	return *this;
 }
 
 
 String& String::operator+=(uint8 other)
 {
-	this->append(String(other));
+	this->append(other);
 	return *this;
 }
 
 
 String& String::operator+=(uint16 other)
 {
-	this->append(String(other));
+	this->append(other);
 	return *this;
 }
 
 
 String& String::operator+=(uint32 other)
 {
-	this->append(String(other));
+	this->append(other);
 	return *this;
 }
 
 
 String& String::operator+=(uint64 other)
 {
-	this->append(String(other));
+	this->append(other);
 	return *this;
 }
 
 
 String& String::operator+=(float other)
 {
-	this->append(String(other));
+	this->append(other);
 	return *this;
 }
 
 
 String& String::operator+=(double other)
 {
-	this->append(String(other));
+	this->append(other);
 	return *this;
 }
 
@@ -525,7 +611,7 @@ String& String::operator+=(double other)
 const String String::operator+(const String& other) const
 {
 	String ret(*this);
-	ret.append(String(other));
+	ret.append(other);
 	return ret;
 }
 
@@ -541,7 +627,7 @@ const String String::operator+(int8 other) const
 const String String::operator+(int16 other) const
 {
 	String ret(*this);
-	ret.append(String(other));
+	ret.append(other);
 	return ret;
 }
 
@@ -549,7 +635,7 @@ const String String::operator+(int16 other) const
 const String String::operator+(int32 other) const
 {
 	String ret(*this);
-	ret.append(String(other));
+	ret.append(other);
 	return ret;
 }
 
@@ -557,7 +643,7 @@ const String String::operator+(int32 other) const
 const String String::operator+(int64 other) const
 {
 	String ret(*this);
-	ret.append(String(other));
+	ret.append(other);
 	return ret;
 }
 
@@ -565,7 +651,7 @@ const String String::operator+(int64 other) const
 const String String::operator+(uint8 other) const
 {
 	String ret(*this);
-	ret.append(String(other));
+	ret.append(other);
 	return ret;
 }
 
@@ -573,7 +659,7 @@ const String String::operator+(uint8 other) const
 const String String::operator+(uint16 other) const
 {
 	String ret(*this);
-	ret.append(String(other));
+	ret.append(other);
 	return ret;
 }
 
@@ -581,7 +667,7 @@ const String String::operator+(uint16 other) const
 const String String::operator+(uint32 other) const
 {
 	String ret(*this);
-	ret.append(String(other));
+	ret.append(other);
 	return ret;
 }
 
@@ -589,7 +675,7 @@ const String String::operator+(uint32 other) const
 const String String::operator+(uint64 other) const
 {
 	String ret(*this);
-	ret.append(String(other));
+	ret.append(other);
 	return ret;
 }
 
@@ -597,7 +683,7 @@ const String String::operator+(uint64 other) const
 const String String::operator+(float other) const
 {
 	String ret(*this);
-	ret.append(String(other));
+	ret.append(other);
 	return ret;
 }
 
@@ -605,7 +691,7 @@ const String String::operator+(float other) const
 const String String::operator+(double other) const
 {
 	String ret(*this);
-	ret.append(String(other));
+	ret.append(other);
 	return ret;
 }
 
@@ -674,6 +760,92 @@ char& String::operator[](uint32 index)
 	return m_str[index];
 }
 
+// Number conversion helpers ------------------------------------------------
+
+/*
+ * Converts the whole of str, apart from white space around it, to an
+ * unsigned number no bigger than maxValue.
+ */
+template <typename T>
+static T toUnsigned(const std::string& str, T maxValue, bool& success)
+{
+	const char* pos = str.c_str();
+	const char* end = pos + str.length();
+
+	while (pos < end && isspace((unsigned char)*pos))
+	{
+		pos++;
+	}
+
+	// Like a stream allow a plus sign, but not a minus sign
+	if (pos < end && *pos == '+')
+	{
+		pos++;
+	}
+
+	uint64 value;
+	uint32 length = String::parseNumber(pos, end, value);
+
+	success = (length > 0 && isSpaceTo(pos + length, end) &&
+		value <= (uint64)maxValue);
+	return success ? (T)value : 0;
+}
+
+/*
+ * Converts the whole of str, apart from white space around it, to a
+ * signed number between minValue and maxValue.
+ */
+template <typename T>
+static T toSigned(const std::string& str, T minValue, T maxValue, bool& success)
+{
+	const char* pos = str.c_str();
+	const char* end = pos + str.length();
+
+	while (pos < end && isspace((unsigned char)*pos))
+	{
+		pos++;
+	}
+
+	if (pos < end && *pos == '+')
+	{
+		pos++;
+	}
+
+	int64 value;
+	uint32 length = String::parseNumber(pos, end, value);
+
+	success = (length > 0 && isSpaceTo(pos + length, end) &&
+		value >= (int64)minValue && value <= (int64)maxValue);
+	return success ? (T)value : 0;
+}
+
+/*
+ * Converts the whole of str, apart from white space around it, to a double.
+ */
+static double toFloatingPoint(const std::string& str, bool& success)
+{
+	const char* start = str.c_str();
+	char* end;
+	double value = strtod(start, &end);
+
+	success = (end != start && isSpaceTo(end, start + str.length()));
+	return success ? value : 0;
+}
+
+/*
+ * Returns true if there is nothing but white space from pos to end. Like a
+ * stream, the conversions stop at white space after the number.
+ */
+static bool isSpaceTo(const char* pos, const char* end)
+{
+	while (pos < end && isspace((unsigned char)*pos))
+	{
+		pos++;
+	}
+
+	return (pos == end);
+}
+
 // Stream functions ---------------------------------------------------------
 
 /*
@@ -30,6 +30,14 @@ public:
 	String();
 	String(const String& str);
 
+#ifdef HAS_RVALUE_REFS
+	/*
+	 * Takes over the text of the passed String without copying it, leaving
+	 * the passed String empty.
+	 */
+	String(String&& str);
+#endif
+
 	/*
 	 * Creates a String from the passed std::string.
 	 */
@@ -58,6 +66,7 @@ public:
 
 	/*
 	 * Creates a string initialized with base 10 text of the passed number.
+	 * Unlike int8, the parameter is treated as a number, not a character.
 	 */
 	String(uint8 n);
 
@@ -118,7 +127,8 @@ public:
 	void append(int64 n);
 
 	/*
-	 * Appends the passed number to the String in base 10.
+	 * Appends the passed number to the String in base 10. Unlike int8, the
+	 * parameter is treated as a number, not a character.
 	 */
 	void append(uint8 n);
 
@@ -152,6 +162,12 @@ public:
 	 */
 	void append(const char* str);
 
+	/*
+	 * Appends length bytes of the passed character data to this String.
+	 * The data may contain null characters.
+	 */
+	void append(const char* data, uint32 length);
+
 	/*
 	 * Appends the String to this String.
 	 */
@@ -163,6 +179,12 @@ public:
 	 */
 	void assign(const String& str);
 
+	/*
+	 * Deletes the String's current text and replaces it with a copy of
+	 * length bytes of the passed character data.
+	 */
+	void assign(const char* data, uint32 length);
+
 	/*
 	 * Returns a null terminated C string. Do not use after modifying the
 	 * String.
@@ -174,6 +196,16 @@ public:
 	 */
 	void clear();
 
+	/*
+	 * Adds count null characters to the end of the String and returns a
+	 * pointer to the first of them, so text can be read straight into the
+	 * String. Room is made geometrically, so repeated calls don't copy the
+	 * text each time. Use setLength() to drop any that weren't filled in.
+	 *
+	 * The pointer is only valid until the String is next modified.
+	 */
+	char* extend(uint32 count);
+
 	/*
 	 * Returns the character at the given index.
 	 *
@@ -271,6 +303,20 @@ public:
 	 */
 	void remove(uint32 index, uint32 count);
 
+	/*
+	 * Exchanges the text of the two Strings without copying either. Lets
+	 * text be handed over where there are no move constructors.
+	 */
+	void swap(String& other);
+
+	/*
+	 * Cuts the String down to length bytes, or pads it with null characters
+	 * up to length bytes.
+	 *
+	 * WARNING: Can create invalid UTF-8 text.
+	 */
+	void setLength(uint32 length);
+
 	/*
 	 * Returns a String that is the substing of this String from index to the
 	 * end of the String. Equivalent to subString(index, length()-1).
@@ -315,6 +361,7 @@ public:
 	 * Attempts to convert the String to an int8 number. If the conversion
 	 * succeeds, success will be set to true and the value returned. If the
 	 * conversion fails, sucess will be set to false and 0 will be returned.
+	 * White space around the number is ignored, but any other text fails.
 	 */
 	int8 toInt8(bool& success) const;
 
@@ -322,6 +369,7 @@ public:
 	 * Attempts to convert the String to an int16 number. If the conversion
 	 * succeeds, success will be set to true and the value returned. If the
 	 * conversion fails, sucess will be set to false and 0 will be returned.
+	 * White space around the number is ignored, but any other text fails.
 	 */
 	int16 toInt16(bool& success) const;
 
@@ -329,6 +377,7 @@ public:
 	 * Attempts to convert the String to an int32 number. If the conversion
 	 * succeeds, success will be set to true and the value returned. If the
 	 * conversion fails, sucess will be set to false and 0 will be returned.
+	 * White space around the number is ignored, but any other text fails.
 	 */
 	int32 toInt32(bool& success) const;
 
@@ -336,6 +385,7 @@ public:
 	 * Attempts to convert the String to an int64 number. If the conversion
 	 * succeeds, success will be set to true and the value returned. If the
 	 * conversion fails, sucess will be set to false and 0 will be returned.
+	 * White space around the number is ignored, but any other text fails.
 	 */
 	int64 toInt64(bool& success) const;
 
@@ -343,6 +393,7 @@ public:
 	 * Attempts to convert the String to an uint8 number. If the conversion
 	 * succeeds, success will be set to true and the value returned. If the
 	 * conversion fails, sucess will be set to false and 0 will be returned.
+	 * White space around the number is ignored, but any other text fails.
 	 */
 	uint8 toUInt8(bool& success) const;
 
@@ -350,6 +401,7 @@ public:
 	 * Attempts to convert the String to an uint16 number. If the conversion
 	 * succeeds, success will be set to true and the value returned. If the
 	 * conversion fails, sucess will be set to false and 0 will be returned.
+	 * White space around the number is ignored, but any other text fails.
 	 */
 	uint16 toUInt16(bool& success) const;
 
@@ -357,6 +409,7 @@ public:
 	 * Attempts to convert the String to an uint32 number. If the conversion
 	 * succeeds, success will be set to true and the value returned. If the
 	 * conversion fails, sucess will be set to false and 0 will be returned.
+	 * White space around the number is ignored, but any other text fails.
 	 */
 	uint32 toUInt32(bool& success) const;
 
@@ -364,6 +417,7 @@ public:
 	 * Attempts to convert the String to an int8 number. If the conversion
 	 * succeeds, success will be set to true and the value returned. If the
 	 * conversion fails, sucess will be set to false and 0 will be returned.
+	 * White space around the number is ignored, but any other text fails.
 	 */
 	uint64 toUInt64(bool& success) const;
 
@@ -371,6 +425,7 @@ public:
 	 * Attempts to convert the String to a float. If the conversion succeeds,
 	 * success will be set to true and the value returned. If the conversion
 	 * fails, sucess will be set to false and 0 will be returned.
+	 * White space around the number is ignored, but any other text fails.
 	 */
 	float toFloat(bool& success) const;
 
@@ -378,11 +433,34 @@ public:
 	 * Attempts to convert the String to a double. If the conversion
 	 * succeeds, success will be set to true and the value returned. If the
 	 * conversion fails, sucess will be set to false and 0 will be returned.
+	 * White space around the number is ignored, but any other text fails.
 	 */
 	double toDouble(bool& success) const;
 
+	/*
+	 * Writes the base 10 text of value to buffer, which must have room for
+	 * 20 characters, and returns the number of characters written. No null
+	 * character is added. Like std::to_chars() nothing is allocated and the
+	 * locale isn't used.
+	 */
+	static uint32 formatNumber(uint64 value, char* buffer);
+	static uint32 formatNumber(int64 value, char* buffer);
+
+	/*
+	 * Reads a base 10 number from text, stopping at end or at the first
+	 * character that isn't a digit, and returns the number of characters
+	 * read. The int64 version also takes a leading minus sign. Like
+	 * std::from_chars() 0 is returned and value left alone if there are no
+	 * digits or the number doesn't fit.
+	 */
+	static uint32 parseNumber(const char* text, const char* end, uint64& value);
+	static uint32 parseNumber(const char* text, const char* end, int64& value);
+
 	// Operators
 	String& operator=(const String& other);
+#ifdef HAS_RVALUE_REFS
+	String& operator=(String&& other);
+#endif
 	String& operator+=(const String& other);
 	String& operator+=(int8 other); // treated as a character, not a number
 	String& operator+=(int16 other);
@@ -0,0 +1,143 @@
+// StringView.cpp
+
+#include "StringView.h"
+
+#include <string.h> // For memchr(), memcmp() and strlen()
+
+
+StringView::StringView()
+{
+	m_data = "";
+	m_length = 0;
+}
+
+StringView::StringView(const char* data, uint32 length)
+{
+	m_data = data;
+	m_length = length;
+}
+
+StringView::StringView(const char* str)
+{
+	m_data = str;
+	m_length = (uint32)strlen(str);
+}
+
+StringView::StringView(const String& str)
+{
+	m_data = str.c_str();
+	m_length = str.length();
+}
+
+StringView::~StringView()
+{
+
+}
+
+const char* StringView::data() const
+{
+	return m_data;
+}
+
+uint32 StringView::length() const
+{
+	return m_length;
+}
+
+char StringView::charAt(uint32 index) const
+{
+	return m_data[index];
+}
+
+StringView StringView::subView(uint32 start, uint32 end) const
+{
+	return StringView(m_data + start, end - start);
+}
+
+bool StringView::equals(const StringView& other) const
+{
+	return m_length == other.m_length &&
+		memcmp(m_data, other.m_data, m_length) == 0;
+}
+
+bool StringView::startsWith(const StringView& prefix) const
+{
+	return m_length >= prefix.m_length &&
+		memcmp(m_data, prefix.m_data, prefix.m_length) == 0;
+}
+
+bool StringView::endsWith(const StringView& suffix) const
+{
+	return m_length >= suffix.m_length &&
+		memcmp(m_data + m_length - suffix.m_length, suffix.m_data,
+			suffix.m_length) == 0;
+}
+
+int32 StringView::compareTo(const StringView& other) const
+{
+	uint32 common = (m_length < other.m_length) ? m_length : other.m_length;
+	int32 result = memcmp(m_data, other.m_data, common);
+
+	if (result != 0)
+		return result;
+	if (m_length == other.m_length)
+		return 0;
+	return (m_length < other.m_length) ? -1 : 1;
+}
+
+bool StringView::operator<(const StringView& other) const
+{
+	return compareTo(other) < 0;
+}
+
+int32 StringView::indexOf(char c) const
+{
+	const char* found = (const char*)memchr(m_data, c, m_length);
+
+	if (found == NULL)
+		return -1;
+	return (int32)(found - m_data);
+}
+
+int32 StringView::lastIndexOf(char c) const
+{
+	for (uint32 i = m_length; i > 0; i--)
+	{
+		if (m_data[i - 1] == c)
+			return (int32)(i - 1);
+	}
+
+	return -1;
+}
+
+int32 StringView::indexOf(const StringView& str) const
+{
+	if (str.m_length == 0)
+		return 0;
+
+	// Look for the first character and check the rest from there
+	uint32 lastStart = m_length - str.m_length;
+
+	for (uint32 i = 0; str.m_length <= m_length && i <= lastStart; i++)
+	{
+		const char* found = (const char*)memchr(m_data + i, str.m_data[0],
+			lastStart - i + 1);
+
+		if (found == NULL)
+			return -1;
+
+		i = (uint32)(found - m_data);
+
+		if (memcmp(found, str.m_data, str.m_length) == 0)
+			return (int32)i;
+	}
+
+	return -1;
+}
+
+String StringView::toString() const
+{
+	String ret;
+	ret.assign(m_data, m_length);
+	return ret;
+}
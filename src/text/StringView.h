@@ -0,0 +1,92 @@
+// StringView.h
+
+#ifndef STRING_VIEW_H
+#define STRING_VIEW_H
+
+#include <ccsponge.h>
+#include <text/String.h>
+
+/*
+ * A read only view of text held somewhere else, usually part of a String.
+ * Nothing is copied or allocated to make one, so it is the cheap way to
+ * pass around or pick apart text that is only looked at.
+ *
+ * The view doesn't own the text. It is only valid while the text it points
+ * at is neither modified nor destroyed.
+ *
+ * Like String this class is encoding agnostic and works on bytes.
+ */
+class StringView
+{
+public:
+	StringView();
+	StringView(const char* data, uint32 length);
+
+	/*
+	 * Views a null terminated C string, not including the null.
+	 */
+	StringView(const char* str);
+
+	/*
+	 * Views the whole of the passed String.
+	 */
+	StringView(const String& str);
+
+	~StringView();
+
+	/*
+	 * Returns the start of the text. It is not null terminated.
+	 */
+	const char* data() const;
+
+	uint32 length() const;
+
+	/*
+	 * Returns the character at the given index.
+	 */
+	char charAt(uint32 index) const;
+
+	/*
+	 * Returns a view of the text from start up to, but not including,
+	 * end.
+	 */
+	StringView subView(uint32 start, uint32 end) const;
+
+	bool equals(const StringView& other) const;
+	bool startsWith(const StringView& prefix) const;
+	bool endsWith(const StringView& suffix) const;
+
+	/*
+	 * Compares byte by byte like strcmp(). Returns a negative number, zero
+	 * or a positive number when this text sorts before, equal to or after
+	 * the other.
+	 */
+	int32 compareTo(const StringView& other) const;
+
+	// Operators
+	bool operator<(const StringView& other) const;
+
+	/*
+	 * Returns the index of the first or last instance of the character,
+	 * or -1 if there is none.
+	 */
+	int32 indexOf(char c) const;
+	int32 lastIndexOf(char c) const;
+
+	/*
+	 * Returns the index of the first instance of str, or -1 if there is
+	 * none.
+	 */
+	int32 indexOf(const StringView& str) const;
+
+	/*
+	 * Copies the viewed text into a new String.
+	 */
+	String toString() const;
+
+private:
+	const char* m_data;
+	uint32 m_length;
+};
+
+#endif // STRING_VIEW_H
@@ -0,0 +1,109 @@
+// CivilDate.cpp
+
+#include "CivilDate.h"
+#include <util/Date.h>
+
+#define SECONDS_PER_DAY 86400
+
+
+CivilDate::CivilDate()
+{
+	m_year = 1970;
+	m_month = 0;
+	m_day = 1;
+}
+
+CivilDate::CivilDate(int32 year, uint32 month, uint32 day)
+{
+	m_year = year;
+	m_month = month;
+	m_day = day;
+}
+
+CivilDate::~CivilDate()
+{
+
+}
+
+CivilDate CivilDate::fromDayNumber(int32 dayNumber)
+{
+	// The inverse of Date::daysFromCivil(). Shift the start to 0000-03-01
+	// so the leap day is the last day of each year, then split the days
+	// into 400 year eras which all have the same number of days.
+	int32 days = dayNumber + 719468;
+	int32 era = (days >= 0 ? days : days - 146096) / 146097;
+	int32 dayOfEra = days - era * 146097; // [0, 146096]
+	int32 yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 -
+		dayOfEra / 146096) / 365; // [0, 399]
+	int32 dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 -
+		yearOfEra / 100); // [0, 365]
+	int32 monthFromMarch = (5 * dayOfYear + 2) / 153; // [0, 11]
+
+	uint32 day = dayOfYear - (153 * monthFromMarch + 2) / 5 + 1;
+	uint32 month = (monthFromMarch + 2) % 12;
+	int32 year = yearOfEra + era * 400;
+
+	if (month < Date::MARCH)
+		year++;
+
+	return CivilDate(year, month, day);
+}
+
+CivilDate CivilDate::fromTime_t(time_t unixTime, int32 utcOffset)
+{
+	time_t localTime = unixTime + utcOffset;
+
+	// Round towards the earlier day for times before 1970
+	time_t dayNumber = localTime / SECONDS_PER_DAY;
+
+	if (localTime % SECONDS_PER_DAY < 0)
+		dayNumber--;
+
+	return fromDayNumber((int32)dayNumber);
+}
+
+int32 CivilDate::getYear() const
+{
+	return m_year;
+}
+
+uint32 CivilDate::getMonth() const
+{
+	return m_month;
+}
+
+uint32 CivilDate::getDayOfMonth() const
+{
+	return m_day;
+}
+
+int32 CivilDate::getDayNumber() const
+{
+	return Date::daysFromCivil(m_year, m_month, m_day);
+}
+
+uint32 CivilDate::getDayOfWeek() const
+{
+	// 1970-01-01 was a Thursday
+	int32 dayOfWeek = (getDayNumber() + Date::THURSDAY) % 7;
+
+	if (dayOfWeek < 0)
+		dayOfWeek += 7;
+
+	return (uint32)dayOfWeek;
+}
+
+String CivilDate::toIsoString() const
+{
+	String ret;
+	ret.append(m_year);
+	ret.append('-');
+	if (m_month + 1 < 10)
+		ret.append('0');
+	ret.append(m_month + 1);
+	ret.append('-');
+	if (m_day < 10)
+		ret.append('0');
+	ret.append(m_day);
+	return ret;
+}
@@ -0,0 +1,62 @@
+// CivilDate.h
+
+#ifndef CIVIL_DATE_H
+#define CIVIL_DATE_H
+
+#include <ccsponge.h>
+#include <text/String.h>
+
+#include <time.h>
+
+/*
+ * A calendar day with no time or time zone, in the proleptic Gregorian
+ * calendar. Unlike Date everything is worked out with integer arithmetic,
+ * so nothing calls localtime() or mktime().
+ *
+ * Each day also has a day number, the days since 1970-01-01, which makes
+ * counting and stepping over days simple.
+ *
+ * Months are zero based [0-11] and days of the month are not [1-31], the
+ * same as Date.
+ */
+class CivilDate
+{
+public:
+	CivilDate();
+	CivilDate(int32 year, uint32 month, uint32 day);
+	~CivilDate();
+
+	/*
+	 * Returns the day the given number of days after 1970-01-01.
+	 */
+	static CivilDate fromDayNumber(int32 dayNumber);
+
+	/*
+	 * Returns the local day of a point in time, given the local time's
+	 * offset from UTC in seconds at that point.
+	 */
+	static CivilDate fromTime_t(time_t unixTime, int32 utcOffset);
+
+	int32 getYear() const;
+	uint32 getMonth() const;
+	uint32 getDayOfMonth() const;
+
+	int32 getDayNumber() const;
+
+	/*
+	 * Zero based [0-6] starting with Sunday, the same as Date.
+	 */
+	uint32 getDayOfWeek() const;
+
+	/*
+	 * Returns the day as YYYY-MM-DD.
+	 */
+	String toIsoString() const;
+
+private:
+	int32 m_year;
+	uint32 m_month;
+	uint32 m_day;
+};
+
+#endif // CIVIL_DATE_H
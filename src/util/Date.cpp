@@ -103,6 +103,19 @@ uint32 Date::getDayOfYear()
 	return tm_struct.tm_yday + 1;
 }
 
+int32 Date::getUtcOffset()
+{
+	tm tm_struct;
+	localtime_r(&m_date, &tm_struct);
+
+	// Treat the local time as if it were UTC and compare
+	time_t localTime = (time_t)daysFromCivil(tm_struct.tm_year + 1900,
+		tm_struct.tm_mon, tm_struct.tm_mday) * 86400 +
+		tm_struct.tm_hour * 3600 + tm_struct.tm_min * 60 + tm_struct.tm_sec;
+
+	return (int32)(localTime - m_date);
+}
+
 void Date::roundToYear()
 {
 	// Make a tm structure out of our time_t
@@ -312,6 +325,24 @@ void Date::init(uint32 year, uint32 month, uint32 day, uint32 hour, uint32 min,
 	m_date = mktime(&tm_struct);
 }
 
+int32 Date::daysFromCivil(int32 year, uint32 month, uint32 day)
+{
+	// Count years from March so the leap day is the last day of the year.
+	// Each 400 year era has the same number of days.
+	if (month < MARCH)
+		year--;
+
+	int32 era = (year >= 0 ? year : year - 399) / 400;
+	int32 yearOfEra = year - era * 400; // [0, 399]
+	int32 monthFromMarch = (month + 10) % 12; // [0, 11]
+	int32 dayOfYear = (153 * monthFromMarch + 2) / 5 + day - 1; // [0, 365]
+	int32 dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 +
+		dayOfYear; // [0, 146096]
+
+	// 719468 is the number of days from 0000-03-01 to 1970-01-01
+	return era * 146097 + dayOfEra - 719468;
+}
+
 int32 Date::getDaysInMonth(int32 month, int32 year)
 {
 	// If not February, return the array value
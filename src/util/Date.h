@@ -71,6 +71,9 @@ public:
 	uint32 getDayOfWeek();
 	uint32 getDayOfYear();
 
+	// Seconds that local time is ahead of UTC at this date
+	int32 getUtcOffset();
+
 	// These functions decrement to the first second in the given time period.
 	void roundToYear();
 	void roundToMonth();
@@ -90,6 +93,14 @@ public:
 	void addMinutes(int32 minutes);
 	void addSeconds(int32 seconds);
 
+	/*
+	 * Returns the number of days from 1970-01-01 to the given date in the
+	 * proleptic Gregorian calendar, negative for earlier dates. Worked out
+	 * with integer arithmetic rather than by the C library, so it takes no
+	 * time zone lock. The month is zero based like the rest of the class.
+	 */
+	static int32 daysFromCivil(int32 year, uint32 month, uint32 day);
+
 	// Operators
 	Date& operator=(const Date& other);
 	bool operator==(const Date& other) const;
@@ -16,6 +16,9 @@
 class NO_VTABLE Runnable
 {
 public:
+	// Tasks are deleted through Runnable pointers once they have run
+	virtual ~Runnable() {}
+
 	virtual void run() = 0;
 };
 
@@ -0,0 +1,59 @@
+// UtcOffsetTable.cpp
+
+#include "UtcOffsetTable.h"
+#include <util/Date.h>
+
+#define SECONDS_PER_DAY 86400
+
+
+UtcOffsetTable::UtcOffsetTable()
+{
+
+}
+
+UtcOffsetTable::~UtcOffsetTable()
+{
+
+}
+
+int32 UtcOffsetTable::getOffset(time_t unixTime)
+{
+	// The UTC day, rounding towards the earlier day for times before 1970
+	time_t day = unixTime / SECONDS_PER_DAY;
+
+	if (unixTime % SECONDS_PER_DAY < 0)
+		day--;
+
+	map<int32, DayOffset>::iterator iter = m_days.find((int32)day);
+
+	if (iter == m_days.end())
+	{
+		time_t dayStart = day * SECONDS_PER_DAY;
+		int32 startOffset = Date(dayStart).getUtcOffset();
+		int32 endOffset = Date(dayStart + SECONDS_PER_DAY - 1).getUtcOffset();
+
+		DayOffset dayOffset;
+		dayOffset.isFixed = (startOffset == endOffset);
+		dayOffset.offset = startOffset;
+
+		iter = m_days.insert(pair<int32, DayOffset>((int32)day, dayOffset)).first;
+	}
+
+	if (iter->second.isFixed)
+	{
+		return iter->second.offset;
+	}
+
+	return Date(unixTime).getUtcOffset();
+}
+
+time_t UtcOffsetTable::getUnixTime(time_t localTime)
+{
+	// Read as UTC the time is at most a day out, so the offset found there
+	// is only wrong near a daylight saving change. Looking again at the
+	// time it gives settles that.
+	int32 offset = getOffset(localTime);
+	int32 correctedOffset = getOffset(localTime - offset);
+
+	return localTime - correctedOffset;
+}
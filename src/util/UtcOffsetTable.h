@@ -0,0 +1,58 @@
+// UtcOffsetTable.h
+
+#ifndef UTC_OFFSET_TABLE_H
+#define UTC_OFFSET_TABLE_H
+
+#include <ccsponge.h>
+
+#include <map>
+#include <time.h>
+using namespace std;
+
+/*
+ * Remembers local time's offset from UTC for each UTC day seen, so that
+ * turning many times into local days doesn't call localtime() for each
+ * one. localtime() takes the C library's time zone lock and looks at the
+ * TZ environment variable on every call.
+ *
+ * The offset is looked up at the start and end of a day the first time
+ * the day is seen. Only on days when daylight saving time starts or ends
+ * do the two differ, and times on those days are looked up one by one.
+ *
+ * Not safe for access by multiple threads.
+ */
+class UtcOffsetTable
+{
+public:
+	UtcOffsetTable();
+	~UtcOffsetTable();
+
+	/*
+	 * Returns the seconds that local time is ahead of UTC at the given
+	 * time.
+	 */
+	int32 getOffset(time_t unixTime);
+
+	/*
+	 * Returns the unix time of a local wall clock time, given as the
+	 * seconds since 1970-01-01 00:00:00 as if local time were UTC. Like
+	 * mktime(), a time in the hour skipped when daylight saving time
+	 * starts, or repeated when it ends, is taken with one of the two
+	 * offsets either side.
+	 */
+	time_t getUnixTime(time_t localTime);
+
+private:
+	UtcOffsetTable(const UtcOffsetTable& other) {}
+	UtcOffsetTable& operator=(const UtcOffsetTable& other) {}
+
+	struct DayOffset
+	{
+		bool isFixed; // False if the offset changes during the day
+		int32 offset;
+	};
+
+	map<int32, DayOffset> m_days;
+};
+
+#endif // UTC_OFFSET_TABLE_H
@@ -41,8 +41,8 @@ void FileInputStream::open(const String fileName)
 		close();
 	}
 
-	// Read access, create if needed
-	int flags = O_RDONLY | O_CREAT;
+	// Read access, only open files that exist
+	int flags = O_RDONLY;
 
 	// Support large files if the OS supports it
 #ifdef O_LARGEFILE
@@ -50,8 +50,8 @@ void FileInputStream::open(const String fileName)
 #endif
 
 	m_fileDescriptor = UnixUtil::sys_open(fileName.c_str(), // Name of file
-										  flags, // Creation flags, see above
-										  0666); // Permissions mask if created
+										  flags, // Open flags, see above
+										  0); // Permissions mask, unused
 
 	if (m_fileDescriptor == -1)
 	{
@@ -92,6 +92,22 @@ int64 FileOutputStream::write(const void* buffer, uint32 maxlen)
 	return internalWrite(buffer, maxlen);
 }
 
+void FileOutputStream::sync()
+{
+	Locker locker(m_mutex);
+
+	if (m_fileDescriptor == -1)
+	{
+		throw IOException("Failed to sync stream: Stream is closed");
+	}
+
+	if (UnixUtil::sys_fsync(m_fileDescriptor) == -1)
+	{
+		throw IOException(String("Failed to sync stream: ") +
+			UnixUtil::getLastErrorMessage());
+	}
+}
+
 int64 FileOutputStream::internalWrite(const void* buffer, uint32 maxlen)
 {
 	Locker locker(m_mutex);
@@ -0,0 +1,61 @@
+// PipeInputStream.cpp
+
+#include "PipeInputStream.h"
+#include <exception/IOException.h>
+#include <util/UnixUtil.h>
+
+#include <errno.h> // For errno defines
+
+
+PipeInputStream::PipeInputStream(int32 fileDescriptor)
+{
+	m_fileDescriptor = fileDescriptor;
+}
+
+PipeInputStream::~PipeInputStream()
+{
+	close();
+}
+
+void PipeInputStream::close()
+{
+	if (m_fileDescriptor != -1)
+	{
+		UnixUtil::sys_close(m_fileDescriptor);
+		m_fileDescriptor = -1;
+	}
+}
+
+int32 PipeInputStream::read()
+{
+	unsigned char tempBuffer[1];
+
+	if (read(tempBuffer, 1) == -1)
+		return -1;
+	return tempBuffer[0];
+}
+
+int64 PipeInputStream::read(void* buffer, uint32 len)
+{
+	if (m_fileDescriptor == -1)
+	{
+		throw IOException("Failed to read from stream: Stream is closed");
+	}
+
+	ssize_t bytesRead = UnixUtil::sys_read(m_fileDescriptor, buffer, (size_t)len);
+
+	// Every writer has closed the pipe
+	if (bytesRead == 0)
+		return -1;
+
+	if (bytesRead == -1)
+	{
+		if (errno == EPIPE)
+			return -1;
+
+		throw IOException(String("Failed to read from stream: ") +
+			UnixUtil::getLastErrorMessage());
+	}
+
+	return bytesRead;
+}
@@ -0,0 +1,41 @@
+// PipeInputStream.h
+
+#ifndef PIPE_INPUT_STREAM_H
+#define PIPE_INPUT_STREAM_H
+
+#include <ccsponge.h>
+#include <io/InputStream.h>
+
+/*
+ * Reads the output of a child process from the parent's end of a pipe.
+ * Only Process makes these.
+ *
+ * Unlike FileInputStream there is no lock and no ioctl() before each read.
+ * Every read is a single read() call, and end of stream is found from
+ * read() returning 0 once the child and everything else holding the write
+ * end has closed it. Process marks its pipes close-on-exec so that other
+ * children it starts don't hold the write end open.
+ *
+ * Not safe for access by multiple threads.
+ */
+class PipeInputStream : public InputStream
+{
+friend class Process;
+
+public:
+	~PipeInputStream();
+
+	void close();
+	int32 read();
+	int64 read(void* buffer, uint32 len);
+
+private:
+	explicit PipeInputStream(int32 fileDescriptor);
+
+	PipeInputStream(const PipeInputStream& other) {};
+	PipeInputStream& operator=(const PipeInputStream& other) {};
+
+	int32 m_fileDescriptor;
+};
+
+#endif // PIPE_INPUT_STREAM_H
@@ -3,15 +3,30 @@
 #include "Process.h"
 #include <exception/IOException.h>
 #include <exception/SystemException.h>
+#include <thread/Mutex.h>
+#include <util/Locker.h>
 #include <util/UnixUtil.h>
 
 #include <errno.h> // For errno
-#include <fcntl.h> // For fcntl()
+#include <fcntl.h> // For fcntl() and O_CLOEXEC
 #include <string.h> // For strcpy()
-#include <unistd.h> // For fork(), _exit()
+#include <unistd.h> // For fork(), _exit(), pipe2()
 #include <sys/types.h> // For wait_pid()
 #include <sys/wait.h> // For wait_pid()
 
+// pipe2() makes a pipe that is close-on-exec from the start
+#if !defined(HAS_PIPE2)
+#	if defined(__linux__) || defined(__FreeBSD__) || defined(__NetBSD__) || \
+	   defined(__OpenBSD__) || defined(__DragonFly__)
+#		define HAS_PIPE2
+#	endif
+#endif
+
+#if !defined(HAS_PIPE2)
+// Held from creating a child's pipes until it has been forked
+static Mutex forkMutex;
+#endif
+
 // Defines the size of buffer used when reading an entire stream
 #define READ_BUFFER_SIZE 1024
 
@@ -186,15 +201,21 @@ void Process::internalExec(const String& programName,
 	int32 stdErrPipe[2] = {-1, -1};
 	int32 childErrorPipe[2] = {-1, -1};
 
+#if !defined(HAS_PIPE2)
+	// Without pipe2() a pipe is briefly inheritable before it is marked
+	// close-on-exec, so no other thread may fork until this one has
+	Locker forkLocker(forkMutex);
+#endif
+
 	// Create pipes for stdin, stdout, stderr
-	if (pipe(stdInPipe) == -1)
+	if (!createPipe(stdInPipe))
 	{
 		throw SystemException(String("Failed to start. Couldn't create pipe: ") +
 			UnixUtil::getLastErrorMessage());
 		return;
 	}
 
-	if (pipe(stdOutPipe) == -1)
+	if (!createPipe(stdOutPipe))
 	{
 		error = errno;
 		closePipe(stdInPipe);
@@ -206,7 +227,7 @@ void Process::internalExec(const String& programName,
 	// Only create a pipe for stderr if we need it
 	if (!mergeOutput)
 	{
-		if (pipe(stdErrPipe) == -1)
+		if (!createPipe(stdErrPipe))
 		{
 			error = errno;
 			closePipe(stdInPipe);
@@ -218,7 +239,7 @@ void Process::internalExec(const String& programName,
 	}
 
 	// And create one more pipe to receive errors past fork() call
-	if (pipe(childErrorPipe) == -1)
+	if (!createPipe(childErrorPipe))
 	{
 		error = errno;
 		closePipe(stdInPipe);
@@ -336,12 +357,12 @@ void Process::internalExec(const String& programName,
 
 		// Make stream objects
 		m_stdin = new FileOutputStream(stdInPipe[1]);
-		m_stdout = new FileInputStream(stdOutPipe[0]);
+		m_stdout = new PipeInputStream(stdOutPipe[0]);
 
 		if (!mergeOutput)
 		{
 			UnixUtil::sys_close(stdErrPipe[1]);
-			m_stderr = new FileInputStream(stdErrPipe[0]);
+			m_stderr = new PipeInputStream(stdErrPipe[0]);
 		}
 
 		m_hasStarted = true;
@@ -362,6 +383,45 @@ void Process::closePipe(int32* aPipe)
 	}
 }
 
+bool Process::createPipe(int32* aPipe)
+{
+	// Don't let other children started at the same time inherit the pipe.
+	// One holding the write end of a stdout pipe would stop its reader ever
+	// seeing the end of the stream. The child's copies on its standard io
+	// descriptors are made with dup2(), which clears the flag.
+#if defined(HAS_PIPE2)
+	return (pipe2(aPipe, O_CLOEXEC) != -1);
+#else
+	if (pipe(aPipe) == -1)
+	{
+		return false;
+	}
+
+	if (!setCloseOnExec(aPipe))
+	{
+		int32 error = errno;
+		closePipe(aPipe);
+		errno = error;
+		return false;
+	}
+
+	return true;
+#endif
+}
+
+bool Process::setCloseOnExec(int32* aPipe)
+{
+	for (uint32 i = 0; i < 2; i++)
+	{
+		if (aPipe[i] != -1 && fcntl(aPipe[i], F_SETFD, FD_CLOEXEC) == -1)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
 char** Process::allocExecArray(const Array<String>& args)
 {
 	// Instead of allocating a multidimensional array of null terminated
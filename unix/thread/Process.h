@@ -5,8 +5,8 @@
 
 #include <ccsponge.h>
 #include <exception/SystemException.h>
-#include <io/FileInputStream.h>
 #include <io/FileOutputStream.h>
+#include <io/PipeInputStream.h>
 #include <text/String.h>
 #include <util/Array.h>
 
@@ -19,6 +19,9 @@
  * process output can result in deadlock or corruption when the output buffer
  * space is limited by the OS.
  *
+ * The streams returned by getStdOut() and getStdErr() must each be read by
+ * only one thread.
+ *
  * Not safe for access by multiple threads.
  */
 class Process
@@ -63,6 +66,8 @@ private:
 					  bool mergeOutput);
 
 	static void closePipe(int32* aPipe);
+	static bool createPipe(int32* aPipe);
+	static bool setCloseOnExec(int32* aPipe);
 	static char** allocExecArray(const Array<String>& args);
 
 private:
@@ -72,8 +77,8 @@ private:
 	pid_t m_pid;
 
 	FileOutputStream* m_stdin;
-	FileInputStream* m_stdout;
-	FileInputStream* m_stderr;
+	PipeInputStream* m_stdout;
+	PipeInputStream* m_stderr;
 };
 
 #endif // UNIX_PROCESS_H
@@ -0,0 +1,31 @@
+// ThreadLocal.cpp
+
+#include "ThreadLocal.h"
+#include <exception/ThreadException.h>
+#include <util/UnixUtil.h>
+
+ThreadLocal::ThreadLocal()
+{
+	int32 error = pthread_key_create(&m_key, NULL);
+
+	if (error != 0)
+	{
+		throw ThreadException(String("Failed to create thread local key: ") +
+			UnixUtil::getErrorMessage(error));
+	}
+}
+
+ThreadLocal::~ThreadLocal()
+{
+	pthread_key_delete(m_key);
+}
+
+void* ThreadLocal::get()
+{
+	return pthread_getspecific(m_key);
+}
+
+void ThreadLocal::set(void* value)
+{
+	pthread_setspecific(m_key, value);
+}
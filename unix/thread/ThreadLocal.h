@@ -0,0 +1,38 @@
+// ThreadLocal.h
+
+#ifndef THREAD_LOCAL_H
+#define THREAD_LOCAL_H
+
+#include <ccsponge.h>
+
+#include <pthread.h>
+
+/*
+ * The Unix ThreadLocal class is a wrapper around a pthread_key_t. Each
+ * thread sees its own pointer, which starts out as NULL.
+ *
+ * Nothing is done with the pointers when a thread exits or the
+ * ThreadLocal is destroyed, so whatever they point at has to be owned
+ * somewhere else.
+ */
+class ThreadLocal
+{
+public:
+	/*
+	 * Throws ThreadException if the key can't be created.
+	 */
+	ThreadLocal();
+	~ThreadLocal();
+
+	void* get();
+	void set(void* value);
+
+private:
+	ThreadLocal(const ThreadLocal& other) {}
+	ThreadLocal& operator=(const ThreadLocal& other) {}
+
+private:
+	pthread_key_t m_key;
+};
+
+#endif // THREAD_LOCAL_H
@@ -5,7 +5,7 @@
 #include <errno.h> // For errno and error defines
 #include <fcntl.h> // For open()
 #include <string.h> // For strerror_r()
-#include <unistd.h> // For dup2(), close(), read(), write()
+#include <unistd.h> // For dup2(), close(), read(), write(), fsync()
 
 
 // Size of buffer for holding error messages
@@ -95,3 +95,16 @@ int UnixUtil::sys_dup2(int oldfd, int newfd)
 
 	return ret;
 }
+
+int UnixUtil::sys_fsync(int fd)
+{
+	int ret;
+
+	do
+	{
+		ret = fsync(fd);
+	}
+	while (ret == -1 && errno == EINTR);
+
+	return ret;
+}
@@ -40,6 +40,8 @@ namespace UnixUtil
 	ssize_t sys_write(int fd, const void* buf, size_t nbyte);
 
 	int sys_dup2(int oldfd, int newfd);
+
+	int sys_fsync(int fd);
 }
 
 #endif // UNIX_UTIL_H
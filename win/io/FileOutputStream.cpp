@@ -115,6 +115,22 @@ int64 FileOutputStream::write(const void* buffer, uint32 maxlen)
 	return writeNormal(buffer, maxlen);
 }
 
+void FileOutputStream::sync()
+{
+	Locker locker(m_mutex);
+
+	if (m_handle == INVALID_HANDLE_VALUE)
+	{
+		throw IOException("Cannot sync closed stream");
+	}
+
+	if (!FlushFileBuffers(m_handle))
+	{
+		throw IOException(String("Failed to sync stream: ") +
+			WinUtil::getLastErrorMessage());
+	}
+}
+
 int64 FileOutputStream::writeNormal(const void* buffer, uint32 maxlen)
 {
 	Locker locker(m_mutex);
@@ -33,6 +33,12 @@ public:
 	int32 write(int32 character);
 	int64 write(const void* buffer, uint32 maxlen);
 
+	/*
+	 * Blocks until everything written so far is on disk rather than only
+	 * in the OS buffers.
+	 */
+	void sync();
+
 private:
 	explicit FileOutputStream(HANDLE handle);
 	void init(const String fileName, bool append);
@@ -0,0 +1,31 @@
+// ThreadLocal.cpp
+
+#include "ThreadLocal.h"
+#include <exception/ThreadException.h>
+#include <util/WinUtil.h>
+
+ThreadLocal::ThreadLocal()
+{
+	m_index = TlsAlloc();
+
+	if (m_index == TLS_OUT_OF_INDEXES)
+	{
+		throw ThreadException(String("Failed to allocate thread local "
+			"storage: ") + WinUtil::getLastErrorMessage());
+	}
+}
+
+ThreadLocal::~ThreadLocal()
+{
+	TlsFree(m_index);
+}
+
+void* ThreadLocal::get()
+{
+	return TlsGetValue(m_index);
+}
+
+void ThreadLocal::set(void* value)
+{
+	TlsSetValue(m_index, value);
+}
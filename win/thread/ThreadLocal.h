@@ -0,0 +1,36 @@
+// ThreadLocal.h
+
+#ifndef THREAD_LOCAL_H
+#define THREAD_LOCAL_H
+
+#include <ccsponge.h>
+
+/*
+ * Windows ThreadLocal implementation. Wrapper around a TLS index. Each
+ * thread sees its own pointer, which starts out as NULL.
+ *
+ * Nothing is done with the pointers when a thread exits or the
+ * ThreadLocal is destroyed, so whatever they point at has to be owned
+ * somewhere else.
+ */
+class ThreadLocal
+{
+public:
+	/*
+	 * Throws ThreadException if no TLS index is left.
+	 */
+	ThreadLocal();
+	~ThreadLocal();
+
+	void* get();
+	void set(void* value);
+
+private:
+	ThreadLocal(const ThreadLocal& other) {}
+	ThreadLocal& operator=(const ThreadLocal& other) {}
+
+private:
+	DWORD m_index;
+};
+
+#endif // THREAD_LOCAL_H